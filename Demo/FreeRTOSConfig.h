@@ -44,7 +44,13 @@
 
 #define configUSE_PREEMPTION                     1
 #define configUSE_IDLE_HOOK                      0
-#define configUSE_TICK_HOOK                      0
+#define configUSE_TICK_HOOK                      1
+/* The one-shot timeline dispatcher (TIMELINE_ONESHOT_TIMER, set on the
+ * command line) needs no tick while nothing is due, so the SysTick is
+ * suppressed in idle gaps as well. */
+#if defined( TIMELINE_ONESHOT_TIMER ) && ( TIMELINE_ONESHOT_TIMER == 1 )
+	#define configUSE_TICKLESS_IDLE              1
+#endif
 #define configCPU_CLOCK_HZ                       ( ( unsigned long ) 25000000 )
 #define configTICK_RATE_HZ                       ( ( TickType_t ) 1000 )
 #define configMINIMAL_STACK_SIZE                 ( ( unsigned short ) 80 )
@@ -56,7 +62,7 @@
 #define configUSE_CO_ROUTINES                    0
 #define configUSE_MUTEXES                        1
 #define configUSE_RECURSIVE_MUTEXES              1
-#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configCHECK_FOR_STACK_OVERFLOW           2
 #define configUSE_MALLOC_FAILED_HOOK             0
 #define configUSE_QUEUE_SETS                     1
 #define configUSE_COUNTING_SEMAPHORES            1
@@ -64,7 +70,8 @@
 #define configMAX_PRIORITIES                     ( 9UL )
 #define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
 #define configQUEUE_REGISTRY_SIZE                10
-#define configSUPPORT_STATIC_ALLOCATION          0
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configUSE_APPLICATION_TASK_TAG           1
 
 /* Timer related defines. */
 #define configUSE_TIMERS                         0
@@ -73,7 +80,7 @@
 #define configTIMER_TASK_STACK_DEPTH             ( configMINIMAL_STACK_SIZE * 2 )
 
 #define configUSE_TASK_NOTIFICATIONS             1
-#define configTASK_NOTIFICATION_ARRAY_ENTRIES    3
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES    4
 
 /* Set the following definitions to 1 to include the API function, or zero
  * to exclude the API function. */
@@ -107,6 +114,18 @@
 	#define configASSERT( x ) if( ( x ) == 0 ) while(1);
 #endif
 
+/* Timestamp every tick edge for the timeline scheduler statistics. The macro
+ * runs before the kernel increments xTickCount, so pass the new value.
+ * Context switches are accounted by the task tag, which holds the utilisation
+ * category of the task; the macro expands inside tasks.c, where pxCurrentTCB
+ * is visible. */
+#if !defined( __IASMARM__ ) && !defined( __ASSEMBLER__ )
+	void vTimelineStatsTickHook( uint32_t xTickCount );
+	void vTimelineStatsTaskSwitchedIn( uint32_t ulCategory );
+	#define traceTASK_INCREMENT_TICK( xTickCount )    vTimelineStatsTickHook( ( xTickCount ) + 1 )
+	#define traceTASK_SWITCHED_IN()                   vTimelineStatsTaskSwitchedIn( ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag )
+#endif
+
 
 /* !!!! configMAX_SYSCALL_INTERRUPT_PRIORITY must not be set to zero !!!!
  * See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html. */
@@ -2,7 +2,22 @@
 #include "task.h"
 #include "uart.h"
 #include "timeline_scheduler.h"
+#include "timeline_channel.h"
+#include "timeline_arena.h"
+#include "timeline_table.h"
 #include "trace.h"
+#include <stdio.h>
+
+// --- Channels ---
+
+/**
+ * @brief State published by HRT1 and polled by SRT1.
+ */
+typedef struct {
+    uint32_t ulRuns; /**< Number of HRT1 jobs that completed. */
+} Hrt1State_t;
+
+TIMELINE_CHANNEL_STATE_DEFINE(xHrt1State, Hrt1State_t, TIMELINE_CHANNEL_KEEP);
 
 // --- Task Implementations ---
 
@@ -10,12 +25,17 @@
  * @brief A simple Hard Real-Time task that completes on time.
  */
 void vTask_HRT1(void *pvParameters) {
+    static uint32_t ulRuns = 0;
+    Hrt1State_t *pxState = pvTimelineChannelWriteBuffer(&xHrt1State);
+
     (void)pvParameters;
     uart_puts("HRT1: Running\r\n");
     vTaskDelay(pdMS_TO_TICKS(20)); // Simulate work
     uart_puts("HRT1: Completed\r\n");
-    // Task must delete itself upon completion
-    vTaskDelete(NULL);
+
+    pxState->ulRuns = ++ulRuns;
+    vTimelineChannelPublish(&xHrt1State);
+    // Returning signals completion; the scheduler reclaims the task
 }
 
 /**
@@ -27,32 +47,90 @@ void vTask_HRT2_DeadlineMiss(void *pvParameters) {
     // This delay will exceed the configured deadline of 30ms
     vTaskDelay(pdMS_TO_TICKS(50)); 
     uart_puts("HRT2: Should have been terminated\r\n");
-    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Reduced version of HRT2, run after a deadline miss under TIMELINE_MISS_DEGRADE.
+ */
+void vTask_HRT2_Degraded(void *pvParameters) {
+    (void)pvParameters;
+    uart_puts("HRT2: Running degraded\r\n");
 }
 
 /**
  * @brief A Soft Real-Time task.
- * Note: The current scheduler implementation does not yet execute SRT tasks.
+ * Runs in the idle time left by the HRT tasks.
  */
 void vTask_SRT1(void *pvParameters) {
+    const Hrt1State_t *pxState = pvTimelineChannelRead(&xHrt1State, NULL);
+    // Scratch memory from the frame arena is never freed; the next frame reuses it
+    char *pcLine = pvTimelineArenaAlloc(48);
+
     (void)pvParameters;
-    uart_puts("SRT1: Running\r\n");
-    vTaskDelete(NULL);
+    if (pxState == NULL || pcLine == NULL) {
+        uart_puts("SRT1: Running\r\n");
+        return;
+    }
+    snprintf(pcLine, 48, "SRT1: Running, HRT1 completed %lu times\r\n", (unsigned long)pxState->ulRuns);
+    uart_puts(pcLine);
+}
+
+
+// --- FreeRTOS Hooks ---
+
+/**
+ * @brief Provides the memory used by the Idle task.
+ *
+ * Required because configSUPPORT_STATIC_ALLOCATION is set to 1.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize) {
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @brief Drives the timeline from the kernel tick when TIMELINE_TICK_DISPATCH is set.
+ *
+ * Required because configUSE_TICK_HOOK is enabled.
+ */
+void vApplicationTickHook(void) {
+    vTimelineSchedulerTickHook();
+}
+
+/**
+ * @brief Names the task whose stack overflowed, then stops.
+ *
+ * Required because configCHECK_FOR_STACK_OVERFLOW is enabled.
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    vTimelineSchedulerReportStackOverflow(xTask, pcTaskName);
+
+    // The task's stack can no longer be trusted
+    taskDISABLE_INTERRUPTS();
+    configASSERT(pdFALSE);
 }
 
 
 // --- Scheduler Configuration ---
 
-const TimelineTaskConfig_t xMyTasks[] = {
-    { vTask_HRT1, "HRT1", TASK_TYPE_HARD_RT, pdMS_TO_TICKS(10), pdMS_TO_TICKS(40), 1 },
-    { vTask_HRT2_DeadlineMiss, "HRT2", TASK_TYPE_HARD_RT, pdMS_TO_TICKS(50), pdMS_TO_TICKS(80), 2 },
-    // { vTask_SRT1, "SRT1", TASK_TYPE_SOFT_RT, 0, 0, 0 }, // SRT task, not yet scheduled
-};
+// Checked by the compiler and placed in flash with its dispatch table; see timeline_table.h.
+// A stack depth of 0 selects TIMELINE_TASK_STACK_DEPTH.
+// HRT2 falls back to its degraded handler in the frame after each miss; SRT1 formats a line and needs a larger stack.
+#define DEMO_TIMELINE(SUBFRAME, HRT, SRT)                                                            \
+    SUBFRAME(0, 0, pdMS_TO_TICKS(50))                                                                \
+    HRT(HRT1, vTask_HRT1, 0, pdMS_TO_TICKS(10), pdMS_TO_TICKS(40), 0, TIMELINE_MISS_KILL, 0, NULL)    \
+    SUBFRAME(1, pdMS_TO_TICKS(50), pdMS_TO_TICKS(100))                                               \
+    HRT(HRT2, vTask_HRT2_DeadlineMiss, 1, pdMS_TO_TICKS(50), pdMS_TO_TICKS(80), 0,                   \
+        TIMELINE_MISS_DEGRADE, 0, vTask_HRT2_Degraded)                                               \
+    SRT(SRT1, vTask_SRT1, configMINIMAL_STACK_SIZE * 4)
 
-const TimelineConfig_t xMyTimeline = {
-    .pxTasks = xMyTasks,
-    .uxNumTasks = sizeof(xMyTasks) / sizeof(TimelineTaskConfig_t)
-};
+TIMELINE_DEFINE(xMyTimeline, DEMO_TIMELINE);
 
 
 int main(int argc, char **argv){
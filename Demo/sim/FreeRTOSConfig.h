@@ -0,0 +1,90 @@
+/*
+ * FreeRTOS configuration of the host simulation build.
+ *
+ * Mirrors ../FreeRTOSConfig.h so that the scheduler sees the same tick rate,
+ * priorities and features as on the MPS2 target, with the changes required by
+ * the FreeRTOS POSIX port. Ticks during which only the idle task would run are
+ * skipped by vSimSuppressTicksAndSleep(), so the simulated clock runs ahead of
+ * the wall clock whenever the system is idle.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_TRACE_FACILITY                 0
+#define configGENERATE_RUN_TIME_STATS            0
+
+#define configUSE_PREEMPTION                     1
+#define configUSE_IDLE_HOOK                      1
+#define configUSE_TICK_HOOK                      1
+#define configCPU_CLOCK_HZ                       ( ( unsigned long ) 25000000 )
+#define configTICK_RATE_HZ                       ( ( TickType_t ) 1000 )
+/* Tasks run on pthreads, whose stacks must be at least PTHREAD_STACK_MIN bytes.
+ * A constant is needed because the static task pool sizes arrays with it. */
+#define configMINIMAL_STACK_SIZE                 ( ( unsigned short ) 4096 )
+#define configTOTAL_HEAP_SIZE                    ( ( size_t ) ( 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                  ( 12 )
+#define configUSE_16_BIT_TICKS                   0
+#define configIDLE_SHOULD_YIELD                  0
+#define configUSE_CO_ROUTINES                    0
+#define configUSE_MUTEXES                        1
+#define configUSE_RECURSIVE_MUTEXES              1
+#define configCHECK_FOR_STACK_OVERFLOW           2
+#define configUSE_MALLOC_FAILED_HOOK             0
+#define configUSE_QUEUE_SETS                     1
+#define configUSE_COUNTING_SEMAPHORES            1
+
+#define configMAX_PRIORITIES                     ( 9UL )
+#define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
+#define configQUEUE_REGISTRY_SIZE                10
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configUSE_APPLICATION_TASK_TAG           1
+
+/* Virtual clock: the idle task hands every idle period to the port macro
+ * below, which jumps the tick count over it instead of waiting. */
+#define configUSE_TICKLESS_IDLE                  1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    2
+
+/* Timer related defines. */
+#define configUSE_TIMERS                         0
+#define configTIMER_TASK_PRIORITY                ( configMAX_PRIORITIES - 4 )
+#define configTIMER_QUEUE_LENGTH                 20
+#define configTIMER_TASK_STACK_DEPTH             ( configMINIMAL_STACK_SIZE * 2 )
+
+#define configUSE_TASK_NOTIFICATIONS             1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES    4
+
+#define INCLUDE_vTaskPrioritySet                  1
+#define INCLUDE_uxTaskPriorityGet                 1
+#define INCLUDE_vTaskDelete                       1
+#define INCLUDE_vTaskCleanUpResources             0
+#define INCLUDE_vTaskSuspend                      1
+#define INCLUDE_vTaskDelayUntil                   1
+#define INCLUDE_vTaskDelay                        1
+#define INCLUDE_uxTaskGetStackHighWaterMark       1
+#define INCLUDE_xTaskGetSchedulerState            1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle    1
+#define INCLUDE_xTaskGetIdleTaskHandle            1
+#define INCLUDE_xSemaphoreGetMutexHolder          1
+#define INCLUDE_eTaskGetState                     1
+#define INCLUDE_xTimerPendFunctionCall            1
+#define INCLUDE_xTaskAbortDelay                   1
+#define INCLUDE_xTaskGetHandle                    1
+
+#define configUSE_STATS_FORMATTING_FUNCTIONS      0
+
+#define configASSERT( x )    if( ( x ) == 0 ) vSimAssertFailed( __FILE__, __LINE__ )
+
+#define configENABLE_BACKWARD_COMPATIBILITY 0
+
+/* The hooks below are shared with the target build, see ../FreeRTOSConfig.h. */
+void vSimAssertFailed( const char * pcFile, unsigned long ulLine );
+void vSimSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+void vTimelineStatsTickHook( uint32_t xTickCount );
+void vTimelineStatsTaskSwitchedIn( uint32_t ulCategory );
+
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vSimSuppressTicksAndSleep( xExpectedIdleTime )
+#define traceTASK_INCREMENT_TICK( xTickCount )               vTimelineStatsTickHook( ( xTickCount ) + 1 )
+#define traceTASK_SWITCHED_IN()                              vTimelineStatsTaskSwitchedIn( ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,91 @@
+/*
+ * Virtual clock and run control of the host simulation build.
+ *
+ * The POSIX port drives the tick from a real-time timer. Whenever only the
+ * idle task can run, the kernel calls portSUPPRESS_TICKS_AND_SLEEP() with the
+ * number of ticks until the next task unblocks; jumping the tick count over
+ * that period makes idle time free, so a run of thousands of major frames
+ * takes about as long as the CPU work done in them.
+ *
+ * The length of a run is set with the SIM_FRAMES environment variable, in
+ * major frames (default 100). SIM_FRAMES=0 runs until the application exits
+ * by itself, as the test runner does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timeline_scheduler.h"
+#include "trace.h"
+
+#define SIM_DEFAULT_FRAMES    100UL
+
+static BaseType_t xSimLengthRead = pdFALSE;
+static BaseType_t xSimRunForever = pdFALSE;
+static TickType_t xSimEndTick = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvSimReadLength( void )
+{
+    const char * pcFrames = getenv( "SIM_FRAMES" );
+    unsigned long ulFrames = ( pcFrames != NULL ) ? strtoul( pcFrames, NULL, 10 ) : SIM_DEFAULT_FRAMES;
+
+    xSimRunForever = ( ulFrames == 0 ) ? pdTRUE : pdFALSE;
+
+    /* Leave the trace drain task one period to print the last frame. */
+    xSimEndTick = ( TickType_t ) ( ulFrames * MAJOR_FRAME_DURATION_TICKS ) + TRACE_DRAIN_PERIOD_TICKS;
+    xSimLengthRead = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vSimSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    /* With TIMELINE_TICK_DISPATCH the timeline's events are invisible to the
+     * kernel's unblock time, so the jump stops on the tick before the next one
+     * and the tick hook processes it in real time. */
+    TickType_t xToEvent = xTimelineSchedulerTicksToNextEvent();
+
+    if( xToEvent <= 1 )
+    {
+        return;
+    }
+
+    if( xExpectedIdleTime > xToEvent - 1 )
+    {
+        xExpectedIdleTime = xToEvent - 1;
+    }
+
+    /* Called by the idle task with the scheduler suspended. vTaskStepTick()
+     * leaves the last tick pending when the jump reaches the next unblock
+     * time, so the woken task runs as soon as the scheduler resumes. The
+     * kernel does not call the tick hook for stepped ticks. */
+    vTaskStepTick( xExpectedIdleTime );
+    vTimelineSchedulerStepTick( xExpectedIdleTime );
+    vTimelineStatsTickHook( xTaskGetTickCount() );
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationIdleHook( void )
+{
+    if( xSimLengthRead == pdFALSE )
+    {
+        prvSimReadLength();
+    }
+
+    if( ( xSimRunForever == pdFALSE ) && ( xTaskGetTickCount() >= xSimEndTick ) )
+    {
+        fflush( stdout );
+        exit( EXIT_SUCCESS );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSimAssertFailed( const char * pcFile, unsigned long ulLine )
+{
+    fflush( stdout );
+    fprintf( stderr, "ASSERT failed: %s:%lu\n", pcFile, ulLine );
+    abort();
+}
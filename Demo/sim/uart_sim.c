@@ -0,0 +1,43 @@
+/*
+ * Host implementation of the uart.h API for the simulation build.
+ *
+ * Everything written to the UART goes to stdout, so the output of a simulated
+ * run can be compared line by line with the serial output of the QEMU build.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "uart.h"
+
+void UART_init( void )
+{
+    /* Full buffering: a long run produces a lot of trace output. */
+    setvbuf( stdout, NULL, _IOFBF, 1 << 16 );
+}
+
+void UART_printf( const char * s )
+{
+    fputs( s, stdout );
+    fflush( stdout );
+}
+
+size_t UART_write( const char * pcData, size_t xLength )
+{
+    return fwrite( pcData, 1, xLength, stdout );
+}
+
+void uart_puts( const char * s )
+{
+    ( void ) UART_write( s, strlen( s ) );
+}
+
+uint32_t UART_getDroppedBytes( void )
+{
+    return 0;
+}
+
+void UART0_TxHandler( void )
+{
+    /* No transmit interrupt on the host. */
+}
@@ -25,6 +25,7 @@
  */
 
 #include "uart.h"
+#include "timeline_timer.h"
 
 /* FreeRTOS interrupt handlers. */
 extern void vPortSVCHandler( void );
@@ -58,15 +59,19 @@ const uint32_t* isr_vector[] __attribute__((section(".isr_vector"), used)) =
     0, // reserved   -3
     ( uint32_t * ) &xPortPendSVHandler, // PendSV handler       -2
     ( uint32_t * ) &xPortSysTickHandler,// SysTick_Handler      -1
+    0, // UART 0 RX  0
+    ( uint32_t * ) &UART0_TxHandler,    // UART 0 TX  1
     0,
     0,
     0,
     0,
     0,
     0,
-    0,
-    0,
+#if ( TIMELINE_ONESHOT_TIMER == 1 )
+    ( uint32_t * ) &TIMER0_Handler,     // Timer 0    8
+#else
     0, // Timer 0
+#endif
     0, // Timer 1
     0,
     0,
@@ -0,0 +1,296 @@
+/**
+ * @file bench_runner.c
+ * @brief Scaling benchmark of the timeline scheduler, run inside one image.
+ *
+ * Replaces main.c in the bench build of the host simulation ("make bench" in
+ * Demo/sim), which raises MAX_TASKS to BENCH_MAX_TASKS. A runner task
+ * generates synthetic timelines of 8, 64, 256 and 512 tasks on the same
+ * major frame, runs each for BENCH_FRAMES frames and prints one row per
+ * timeline:
+ *
+ * - the scheduler's CPU share per frame (mean and worst) and its cycles per
+ *   released job, which stays flat when the cost of an event does not depend
+ *   on the task count;
+ * - the release latency of the HRT jobs (best and worst) and its spread, the
+ *   release jitter;
+ * - the RAM of the scheduler per task slot and for the active schedule, and
+ *   the per-task statistics record.
+ *
+ * Every seventh task of a timeline is an SRT task; the HRT tasks get one-tick
+ * windows spread evenly over the frame, so the load per tick grows with the
+ * task count. Times are in timeline_stats cycles, converted to microseconds
+ * with configCPU_CLOCK_HZ. The simulation measures the host, so the figures
+ * are meaningful relative to each other rather than as target timings.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uart.h"
+#include "timeline_scheduler.h"
+#include "timeline_stats.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// --- Bench Definitions ---
+
+/**
+ * @brief Largest timeline of the benchmark. The build must set MAX_TASKS at least this high.
+ */
+#ifndef BENCH_MAX_TASKS
+#define BENCH_MAX_TASKS 512
+#endif
+
+/**
+ * @brief Major frames run per timeline.
+ */
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES 8
+#endif
+
+/**
+ * @brief Length of the major frame of every timeline, in ticks, and of its two sub-frames.
+ */
+#define BENCH_FRAME_TICKS    1024
+#define BENCH_SUBFRAME_TICKS (BENCH_FRAME_TICKS / 2)
+
+/**
+ * @brief Iterations of the busy loop each job runs.
+ */
+#define BENCH_JOB_LOOPS 200
+
+/**
+ * @brief Every BENCH_SRT_PERIOD-th task is an SRT task.
+ */
+#define BENCH_SRT_PERIOD 7
+
+/**
+ * @brief Priority of the runner task, as in the test runner.
+ */
+#define BENCH_RUNNER_PRIORITY (TIMELINE_HRT_PRIORITY + 1)
+
+#define BENCH_COUNT_OF(x) (sizeof(x) / sizeof((x)[0]))
+
+#define BENCH_CYCLES_PER_US (configCPU_CLOCK_HZ / 1000000UL)
+
+#if (BENCH_MAX_TASKS > MAX_TASKS)
+#error "The bench build must raise MAX_TASKS to BENCH_MAX_TASKS"
+#endif
+
+#if (BENCH_MAX_TASKS - BENCH_MAX_TASKS / BENCH_SRT_PERIOD) > BENCH_FRAME_TICKS / 2
+#error "The HRT windows of the largest timeline do not fit in BENCH_FRAME_TICKS"
+#endif
+
+// --- Private State ---
+
+static const UBaseType_t uxBenchSizes[] = { 8, 64, 256, 512 };
+
+static TimelineTaskConfig_t xBenchTasks[BENCH_MAX_TASKS];
+static char cBenchNames[BENCH_MAX_TASKS][8];
+static TimelineConfig_t xBenchConfig;
+
+// --- Bench Jobs ---
+
+static void prvBenchJob(void *pvParameters) {
+    (void)pvParameters;
+    for (volatile uint32_t i = 0; i < BENCH_JOB_LOOPS; i++) {
+    }
+}
+
+// --- Private Functions ---
+
+/**
+ * @brief Fills xBenchConfig with a timeline of uxTasks tasks.
+ *
+ * The HRT windows are one tick long and spread evenly over the frame, at
+ * least two ticks apart, so no window crosses the sub-frame boundary and a
+ * deadline never falls on the tick of the next release.
+ */
+static void prvGenerateTimeline(UBaseType_t uxTasks) {
+    UBaseType_t uxHard = uxTasks - uxTasks / BENCH_SRT_PERIOD;
+    uint32_t ulSpacing = BENCH_FRAME_TICKS / uxHard;
+    UBaseType_t uxNextHard = 0;
+
+    memset(xBenchTasks, 0, sizeof(xBenchTasks));
+    for (UBaseType_t i = 0; i < uxTasks; i++) {
+        TimelineTaskConfig_t *pxTask = &xBenchTasks[i];
+
+        snprintf(cBenchNames[i], sizeof(cBenchNames[i]), "B%lu", (unsigned long)i);
+        pxTask->pvTaskCode = prvBenchJob;
+        pxTask->pcName = cBenchNames[i];
+
+        if ((i + 1) % BENCH_SRT_PERIOD == 0) {
+            pxTask->xTaskType = TASK_TYPE_SOFT_RT;
+            continue;
+        }
+        pxTask->xTaskType = TASK_TYPE_HARD_RT;
+        pxTask->ulStartTimeTicks = uxNextHard * ulSpacing;
+        pxTask->ulEndTimeTicks = pxTask->ulStartTimeTicks + 1;
+        pxTask->ulSubframeId = pxTask->ulStartTimeTicks / BENCH_SUBFRAME_TICKS;
+        pxTask->xMissPolicy = TIMELINE_MISS_KILL;
+        uxNextHard++;
+    }
+
+    xBenchConfig.pxTasks = xBenchTasks;
+    xBenchConfig.uxNumTasks = uxTasks;
+    xBenchConfig.ulMajorFrameTicks = BENCH_FRAME_TICKS;
+    xBenchConfig.ulSubframeTicks = BENCH_SUBFRAME_TICKS;
+    xBenchConfig.pxTable = NULL;
+}
+
+/**
+ * @brief Formats a cycle count as microseconds with one decimal.
+ */
+static void prvFormatUs(char *pcBuffer, size_t xSize, uint32_t ulCycles) {
+    uint32_t ulTenths = (uint32_t)(((uint64_t)ulCycles * 10U) / BENCH_CYCLES_PER_US);
+
+    snprintf(pcBuffer, xSize, "%lu.%lu", (unsigned long)(ulTenths / 10), (unsigned long)(ulTenths % 10));
+}
+
+/**
+ * @brief Runs one timeline and prints its row.
+ */
+static void prvRunTimeline(UBaseType_t uxTasks) {
+    TimelineSchedulerStats_t xScheduler;
+    TimelineMemoryUsage_t xMemory;
+    uint32_t ulLatencyMin = UINT32_MAX;
+    uint32_t ulLatencyMax = 0;
+    uint32_t ulLost = 0;
+    char cMin[16];
+    char cMax[16];
+    char cJitter[16];
+    char cPerJob[16];
+    char cLine[256];
+
+    prvGenerateTimeline(uxTasks);
+    if (xTimelineSchedulerInit(&xBenchConfig) != pdPASS) {
+        snprintf(cLine, sizeof(cLine), "bench %4lu tasks: init failed\r\n", (unsigned long)uxTasks);
+        uart_puts(cLine);
+        return;
+    }
+
+    vTaskDelay(BENCH_FRAMES * BENCH_FRAME_TICKS + 1);
+    vTimelineSchedulerGetMemoryUsage(&xMemory);
+    vTimelineSchedulerStop();
+
+    for (UBaseType_t i = 0; i < uxTasks; i++) {
+        TimelineTaskStats_t xStats;
+        TimelineTaskCounters_t xCounters;
+
+        if (xTimelineSchedulerGetTaskCounters(i, &xCounters) == pdPASS) {
+            ulLost += xCounters.ulMisses + xCounters.ulOverruns;
+        }
+        if (xBenchTasks[i].xTaskType != TASK_TYPE_HARD_RT || xTimelineStatsGetTask(i, &xStats) != pdPASS ||
+            xStats.xReleaseLatency.ulCount == 0) {
+            continue;
+        }
+        if (xStats.xReleaseLatency.ulMin < ulLatencyMin) {
+            ulLatencyMin = xStats.xReleaseLatency.ulMin;
+        }
+        if (xStats.xReleaseLatency.ulMax > ulLatencyMax) {
+            ulLatencyMax = xStats.xReleaseLatency.ulMax;
+        }
+    }
+    if (ulLatencyMin > ulLatencyMax) {
+        ulLatencyMin = ulLatencyMax;
+    }
+
+    vTimelineStatsGetScheduler(&xScheduler);
+    prvFormatUs(cMin, sizeof(cMin), ulLatencyMin);
+    prvFormatUs(cMax, sizeof(cMax), ulLatencyMax);
+    prvFormatUs(cJitter, sizeof(cJitter), ulLatencyMax - ulLatencyMin);
+    prvFormatUs(cPerJob, sizeof(cPerJob), xScheduler.ulLastSchedulerCycles / (uint32_t)uxTasks);
+
+    const TimelineStatSeries_t *pxShare = &xScheduler.xSharePermille;
+    uint32_t ulShareMean = (pxShare->ulCount != 0) ? (uint32_t)(pxShare->ullSum / pxShare->ulCount) : 0;
+
+    snprintf(cLine, sizeof(cLine),
+             "bench %4lu tasks | sched %2lu.%lu%% max %2lu.%lu%% %6s us/job | release %6s..%6s us jitter %6s us"
+             " | slot %lu B active %lu B reserved %lu B stats %lu B/task | lost %lu\r\n",
+             (unsigned long)uxTasks, (unsigned long)(ulShareMean / 10), (unsigned long)(ulShareMean % 10),
+             (unsigned long)(pxShare->ulMax / 10), (unsigned long)(pxShare->ulMax % 10), cPerJob, cMin, cMax,
+             cJitter, (unsigned long)xMemory.xTaskSlotBytes, (unsigned long)xMemory.xActiveBytes,
+             (unsigned long)xMemory.xReservedBytes, (unsigned long)sizeof(TimelineTaskStats_t),
+             (unsigned long)ulLost);
+    uart_puts(cLine);
+}
+
+/**
+ * @brief Runs every timeline size, then exits.
+ */
+static void prvRunnerTask(void *pvParameters) {
+    (void)pvParameters;
+
+    for (UBaseType_t i = 0; i < BENCH_COUNT_OF(uxBenchSizes); i++) {
+        if (uxBenchSizes[i] <= BENCH_MAX_TASKS) {
+            prvRunTimeline(uxBenchSizes[i]);
+        }
+    }
+
+    // Let the trace drain task and the UART empty their buffers
+    vTaskDelay(pdMS_TO_TICKS(100));
+    fflush(stdout);
+    exit(0);
+}
+
+// --- FreeRTOS Hooks ---
+
+/**
+ * @brief Provides the memory used by the Idle task.
+ *
+ * Required because configSUPPORT_STATIC_ALLOCATION is set to 1.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize) {
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @brief Drives the timeline from the kernel tick when TIMELINE_TICK_DISPATCH is set.
+ *
+ * Required because configUSE_TICK_HOOK is enabled.
+ */
+void vApplicationTickHook(void) {
+    vTimelineSchedulerTickHook();
+}
+
+/**
+ * @brief Aborts the run on a stack overflow, naming the task.
+ *
+ * Required because configCHECK_FOR_STACK_OVERFLOW is enabled.
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    vTimelineSchedulerReportStackOverflow(xTask, pcTaskName);
+    fflush(stdout);
+    exit(1);
+}
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+/**
+ * @brief Unused: the bench timelines only use TIMELINE_MISS_KILL.
+ *
+ * Required because TIMELINE_USE_DEADLINE_HOOK is enabled.
+ */
+void vApplicationTimelineDeadlineHook(UBaseType_t uxTaskIndex, const char *pcTaskName) {
+    (void)uxTaskIndex;
+    (void)pcTaskName;
+}
+#endif
+
+int main(void) {
+    UART_init();
+    uart_puts("--- Timeline Scheduler Scaling Bench ---\r\n");
+
+    xTaskCreate(prvRunnerTask, "BenchRunner", configMINIMAL_STACK_SIZE * 6, NULL, BENCH_RUNNER_PRIORITY, NULL);
+    vTaskStartScheduler();
+
+    for (;;) {
+    }
+}
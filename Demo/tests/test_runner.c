@@ -0,0 +1,1376 @@
+/**
+ * @file test_runner.c
+ * @brief Regression suite for the timeline scheduler, run inside one image.
+ *
+ * Replaces main.c in the test build. A runner task executes a catalogue of
+ * timelines back-to-back: each case initialises the scheduler with its own
+ * configuration, lets it run for a few major frames while every trace event
+ * is captured through the trace record hook, stops it with
+ * vTimelineSchedulerStop() and checks the captured events against the
+ * expected sequence and timing. The result of every case is printed as
+ * "Test N - name: PASSED" or "Test N - name: FAILED (reason)".
+ *
+ * At the end the image exits with status 0 if every case passed and 1
+ * otherwise: through ARM semihosting under QEMU, or exit() in the host
+ * simulation build.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uart.h"
+#include "timeline_scheduler.h"
+#include "timeline_table.h"
+#include "timeline_mutex.h"
+#include "timeline_channel.h"
+#include "timeline_state.h"
+#include "timeline_arena.h"
+#include "timeline_stats.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(TIMELINE_SIM)
+#include <stdlib.h>
+#endif
+
+// --- Test Definitions ---
+
+/**
+ * @brief Maximum number of trace events captured per case.
+ */
+#define TEST_CAPTURE_LENGTH 512
+
+/**
+ * @brief Priority of the runner task: above the jobs, so that busy jobs cannot
+ * starve it, and below the scheduler, which it stops.
+ */
+#define TEST_RUNNER_PRIORITY (TIMELINE_HRT_PRIORITY + 1)
+
+/**
+ * @brief Ticks a case keeps running after its last frame, so that the events
+ * at the end of that frame are captured.
+ */
+#define TEST_SETTLE_TICKS 5
+
+/**
+ * @brief Task id used by expectations on scheduler events.
+ */
+#define SCHED TRACE_TASK_ID_SCHEDULER
+
+/**
+ * @brief One expected event, at a tick relative to the start of the first frame.
+ */
+typedef struct {
+    uint8_t ucEvent;      /**< One of TraceEvent_t. */
+    uint16_t usTaskId;    /**< Managed task index, or SCHED. */
+    uint32_t ulOffset;    /**< Expected tick, relative to the first MAJOR_FRAME_START. */
+    uint32_t ulTolerance; /**< Accepted deviation in ticks, either way. */
+} TestExpectation_t;
+
+/**
+ * @brief One case of the catalogue.
+ */
+typedef struct {
+    const char *pcName;
+    const TimelineConfig_t *pxConfig;
+    BaseType_t xExpectInitFail;           /**< pdTRUE if xTimelineSchedulerInit() must reject the configuration. */
+    uint32_t ulFrames;                    /**< Number of major frames to run. */
+    const TestExpectation_t *pxExpected;  /**< Events that must appear, in this order. */
+    UBaseType_t uxExpected;
+    const uint8_t *pucForbidden;          /**< Events that must not appear at all. */
+    UBaseType_t uxForbidden;
+    void (*pvSetup)(void);                /**< Optional preparation run before init. */
+    BaseType_t (*pxCheck)(char *pcReason, size_t xSize); /**< Optional extra check run after the case. */
+} TestCase_t;
+
+#define TEST_COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+// --- Private State ---
+
+static TraceRecord_t xCaptured[TEST_CAPTURE_LENGTH];
+static volatile UBaseType_t uxCaptured = 0;
+static volatile BaseType_t xCaptureEnabled = pdFALSE;
+
+static const char *const pcEventNames[] = {
+    "MAJOR_FRAME_START", "TASK_SPAWN", "TASK_COMPLETE", "DEADLINE_MISS", "TASK_CREATE_FAILED",
+    "IDLE_START", "IDLE_END", "SUBFRAME_START", "RELEASE_SKIPPED", "FRAME_OVERRUN", "SRT_INCOMPLETE",
+    "SWITCH_REQUEST", "SCHEDULE_SWITCH", "STACK_OVERFLOW", "ABORT_REQUEST", "JOB_ABORTED", "JOB_RECLAIMED",
+    "STATE_RESET",
+};
+
+// --- Test Jobs ---
+
+/** @brief Completes after 5 ticks. */
+static void prvJobShort(void *pvParameters) {
+    (void)pvParameters;
+    vTaskDelay(5);
+}
+
+/** @brief Completes immediately. */
+static void prvJobNop(void *pvParameters) {
+    (void)pvParameters;
+}
+
+/** @brief Never completes within any window. */
+static void prvJobEndless(void *pvParameters) {
+    (void)pvParameters;
+    vTaskDelay(10 * MAJOR_FRAME_DURATION_TICKS);
+}
+
+/** @brief Completes one tick before the end of a 10-tick window. */
+static void prvJobNineTicks(void *pvParameters) {
+    (void)pvParameters;
+    vTaskDelay(9);
+}
+
+/** @brief Completes exactly at the end of a 10-tick window. */
+static void prvJobTenTicks(void *pvParameters) {
+    (void)pvParameters;
+    vTaskDelay(10);
+}
+
+/** @brief Keeps the CPU busy for 30 ticks of wall time. */
+static void prvJobBusy(void *pvParameters) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    (void)pvParameters;
+    while ((xTaskGetTickCount() - xStart) < 30) {
+    }
+}
+
+/** @brief Polls for the abort request and returns once asked. */
+static void prvJobUntilAbort(void *pvParameters) {
+    (void)pvParameters;
+    while (xTimelineJobAbortRequested() == pdFALSE) {
+        vTaskDelay(1);
+    }
+}
+
+static TimelineMutex_t xTestMutex;
+static volatile uint32_t ulMutexTakes = 0;
+
+/** @brief Takes the test mutex if it is free, then never completes. */
+static void prvJobHoldMutex(void *pvParameters) {
+    (void)pvParameters;
+    if (xTimelineMutexTake(&xTestMutex, 0) == pdPASS) {
+        ulMutexTakes++;
+    }
+    vTaskDelay(10 * MAJOR_FRAME_DURATION_TICKS);
+}
+
+TIMELINE_CHANNEL_STATE_DEFINE(xTestState, uint32_t, TIMELINE_CHANNEL_PER_FRAME);
+TIMELINE_RING_CHANNEL_DEFINE(xTestRing, uint32_t, 4, TIMELINE_CHANNEL_PER_FRAME);
+static volatile uint32_t ulChannelReads = 0;
+static volatile uint32_t ulChannelMessages = 0;
+static volatile uint32_t ulChannelErrors = 0;
+
+/** @brief Publishes the frame count and queues it twice, then is killed in the middle of more writes. */
+static void prvJobProducer(void *pvParameters) {
+    uint32_t ulFrame = ulTimelineSchedulerGetFrameCount();
+    uint32_t *pulSlot;
+
+    (void)pvParameters;
+    *(uint32_t *)pvTimelineChannelWriteBuffer(&xTestState) = ulFrame;
+    vTimelineChannelPublish(&xTestState);
+    for (UBaseType_t i = 0; i < 2; i++) {
+        pulSlot = pvTimelineRingClaim(&xTestRing);
+        if (pulSlot != NULL) {
+            *pulSlot = ulFrame;
+            vTimelineRingCommit(&xTestRing);
+        }
+    }
+
+    // Neither is published when the deadline kills the job
+    *(uint32_t *)pvTimelineChannelWriteBuffer(&xTestState) = 0xDEADU;
+    pulSlot = pvTimelineRingClaim(&xTestRing);
+    if (pulSlot != NULL) {
+        *pulSlot = 0xDEADU;
+    }
+    vTaskDelay(10 * MAJOR_FRAME_DURATION_TICKS);
+}
+
+/** @brief Checks the state and drains the messages published in the current frame. */
+static void prvJobConsumer(void *pvParameters) {
+    uint32_t ulFrame = ulTimelineSchedulerGetFrameCount();
+    const uint32_t *pulState = pvTimelineChannelRead(&xTestState, NULL);
+    const uint32_t *pulMessage;
+
+    (void)pvParameters;
+    if (pulState != NULL && *pulState == ulFrame) {
+        ulChannelReads++;
+    } else {
+        ulChannelErrors++;
+    }
+
+    while ((pulMessage = pvTimelineRingPeek(&xTestRing)) != NULL) {
+        if (*pulMessage == ulFrame) {
+            ulChannelMessages++;
+        } else {
+            ulChannelErrors++;
+        }
+        vTimelineRingConsume(&xTestRing);
+    }
+}
+
+typedef struct {
+    uint32_t ulWords[4];
+} TestKillState_t;
+
+TIMELINE_CHANNEL_STATE_DEFINE(xTestKillState, TestKillState_t, TIMELINE_CHANNEL_KEEP);
+static volatile BaseType_t xKillGapCheck = pdFALSE;
+static volatile uint32_t ulKillSequence = 0;
+static volatile uint32_t ulKillLastSeen = 0;
+static volatile uint32_t ulKillReads = 0;
+static volatile uint32_t ulKillTorn = 0;
+static volatile uint32_t ulKillGapTicks = 0;
+
+/**
+ * @brief Tick hook of the kill case: counts the ticks that find a buffer of
+ * the channel lost or owned twice, where a kill would leave it broken.
+ */
+static void prvCheckKillGap(void) {
+    uint8_t ucShared = xTestKillState.ucShared & 0x03U;
+    uint8_t ucBack = xTestKillState.ucBack;
+    uint8_t ucFront = xTestKillState.ucFront;
+
+    if (xKillGapCheck != pdFALSE &&
+        (ucShared > 2U || ucBack > 2U || ucFront > 2U || ucShared == ucBack || ucShared == ucFront ||
+         ucBack == ucFront)) {
+        ulKillGapTicks++;
+    }
+}
+
+/** @brief Publishes a new sequence number in every word of the state until the deadline kills it. */
+static void prvJobKillProducer(void *pvParameters) {
+    (void)pvParameters;
+    for (;;) {
+        TestKillState_t *pxState = pvTimelineChannelWriteBuffer(&xTestKillState);
+        uint32_t ulSequence = ++ulKillSequence;
+
+        for (UBaseType_t i = 0; i < TEST_COUNT_OF(pxState->ulWords); i++) {
+            pxState->ulWords[i] = ulSequence;
+        }
+        vTimelineChannelPublish(&xTestKillState);
+    }
+}
+
+/** @brief Reads the state until the frame end kills it, counting values torn or out of order. */
+static void prvJobKillConsumer(void *pvParameters) {
+    (void)pvParameters;
+    for (;;) {
+        BaseType_t xFresh;
+        const TestKillState_t *pxState = pvTimelineChannelRead(&xTestKillState, &xFresh);
+
+        if (pxState == NULL || xFresh == pdFALSE) {
+            continue;
+        }
+        ulKillReads++;
+        for (UBaseType_t i = 1; i < TEST_COUNT_OF(pxState->ulWords); i++) {
+            if (pxState->ulWords[i] != pxState->ulWords[0]) {
+                ulKillTorn++;
+            }
+        }
+        if (pxState->ulWords[0] <= ulKillLastSeen) {
+            ulKillTorn++;
+        }
+        ulKillLastSeen = pxState->ulWords[0];
+    }
+}
+
+typedef struct {
+    uint32_t ulRuns;
+    uint8_t ucHistory[8];
+} TestFrameState_t;
+
+TIMELINE_STATE_BLOCK_DEFINE(xTestFrameState, TestFrameState_t, { 5U, { 1U, 2U, 3U } });
+static uint32_t ulTestScratch[4];
+static volatile uint32_t ulStateErrors = 0;
+
+/** @brief Checks that the registered blocks hold their initial image, then changes them. */
+static void prvJobMutateState(void *pvParameters) {
+    (void)pvParameters;
+    if (memcmp(&xTestFrameState, &xTestFrameStateImage, sizeof(xTestFrameState)) != 0 || ulTestScratch[0] != 0) {
+        ulStateErrors++;
+    }
+    xTestFrameState.ulRuns++;
+    xTestFrameState.ucHistory[7] = 0xFFU;
+    ulTestScratch[0] = 0xDEADU;
+}
+
+#define TEST_ARENA_ROUND(xSize) (((xSize) + TIMELINE_ARENA_ALIGNMENT - 1) & ~(size_t)(TIMELINE_ARENA_ALIGNMENT - 1))
+static uint8_t *pucArenaStart = NULL;
+static uint8_t *pucArenaNext = NULL;
+static volatile uint32_t ulArenaErrors = 0;
+
+/** @brief Allocates twice at the start of a fresh arena, then more than is left. */
+static void prvJobArenaFirst(void *pvParameters) {
+    uint8_t *pucA = pvTimelineArenaAlloc(3);
+    uint8_t *pucB = pvTimelineArenaAlloc(100);
+
+    (void)pvParameters;
+    // Every frame starts from the same, rewound arena
+    if (pucArenaStart == NULL) {
+        pucArenaStart = pucA;
+    }
+    if (pucA == NULL || pucA != pucArenaStart || ((uintptr_t)pucA & (TIMELINE_ARENA_ALIGNMENT - 1)) != 0 ||
+        pucB != pucA + TEST_ARENA_ROUND(3)) {
+        ulArenaErrors++;
+        return;
+    }
+    memset(pucB, 0xA5, 100);
+    if (pvTimelineArenaAlloc(TIMELINE_ARENA_BYTES) != NULL) {
+        ulArenaErrors++;
+    }
+    pucArenaNext = pucB + TEST_ARENA_ROUND(100);
+}
+
+/** @brief Allocates in the next sub-frame, after or over the first job's memory. */
+static void prvJobArenaSecond(void *pvParameters) {
+    uint8_t *pucC = pvTimelineArenaAlloc(40);
+
+    (void)pvParameters;
+#if (TIMELINE_ARENA_PER_SUBFRAME == 1)
+    if (pucC != pucArenaStart) {
+#else
+    if (pucC != pucArenaNext) {
+#endif
+        ulArenaErrors++;
+    }
+}
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_STACK_PROFILING == 1)
+#define TEST_STACK_DEPTH (configMINIMAL_STACK_SIZE * 2)
+#define TEST_STACK_FILL_WORDS (configMINIMAL_STACK_SIZE / 2)
+
+static volatile StackType_t uxStackSink = 0;
+
+/** @brief Writes TEST_STACK_FILL_WORDS words of its stack, then completes. */
+static void prvJobUseStack(void *pvParameters) {
+    volatile StackType_t uxFill[TEST_STACK_FILL_WORDS];
+
+    (void)pvParameters;
+    for (UBaseType_t i = 0; i < TEST_STACK_FILL_WORDS; i++) {
+        uxFill[i] = (StackType_t)i;
+    }
+    uxStackSink = uxFill[TEST_STACK_FILL_WORDS - 1];
+}
+
+/** @brief Uses the same stack as prvJobUseStack(), then never completes. */
+static void prvJobUseStackEndless(void *pvParameters) {
+    prvJobUseStack(pvParameters);
+    vTaskDelay(10 * MAJOR_FRAME_DURATION_TICKS);
+}
+#endif
+
+#if (TIMELINE_TICK_DISPATCH == 0)
+static BaseType_t xStallDone = pdFALSE;
+
+/** @brief Holds the scheduler task suspended for 120 ticks, once per case. */
+static void prvJobStallScheduler(void *pvParameters) {
+    TaskHandle_t xScheduler = xTaskGetHandle("Scheduler");
+
+    (void)pvParameters;
+    if (xStallDone != pdFALSE || xScheduler == NULL) {
+        return;
+    }
+    xStallDone = pdTRUE;
+
+    vTaskSuspend(xScheduler);
+    vTaskDelay(120);
+    vTaskResume(xScheduler);
+}
+#endif
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+static volatile uint32_t ulDeadlineHookCalls = 0;
+#endif
+
+static UBaseType_t uxSwitchTarget = 0;
+
+/** @brief Requests a switch to the schedule registered by the case setup. */
+static void prvJobRequestSwitch(void *pvParameters) {
+    (void)pvParameters;
+    (void)xTimelineSchedulerRequestSwitch(uxSwitchTarget);
+}
+
+// --- Test Catalogue ---
+
+static const uint8_t ucNoMisses[] = {
+    TRACE_EVENT_DEADLINE_MISS, TRACE_EVENT_RELEASE_SKIPPED, TRACE_EVENT_FRAME_OVERRUN, TRACE_EVENT_TASK_CREATE_FAILED,
+};
+
+// Case: two short jobs in their own sub-frames
+static const TimelineTaskConfig_t xNominalTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobShort, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 60, .ulEndTimeTicks = 70, .ulSubframeId = 1 },
+};
+static const TimelineConfig_t xNominal = { xNominalTasks, TEST_COUNT_OF(xNominalTasks), 0, 0, NULL };
+static const TestExpectation_t xNominalExpected[] = {
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 0, 0 },
+    { TRACE_EVENT_SUBFRAME_START, SCHED, 0, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 15, 1 },
+    { TRACE_EVENT_SUBFRAME_START, SCHED, 50, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 60, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 65, 1 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 100, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 160, 0 },
+};
+
+// Case: a release inside a window still owned by another job is skipped
+static const TimelineTaskConfig_t xOverlapTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 30, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobShort, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 20, .ulEndTimeTicks = 40, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xOverlap = { xOverlapTasks, TEST_COUNT_OF(xOverlapTasks), 0, 0, NULL };
+static const TestExpectation_t xOverlapExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_RELEASE_SKIPPED, 1, 20, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 30, 0 },
+};
+
+static BaseType_t prvCheckOverlap(char *pcReason, size_t xSize) {
+    TimelineTaskCounters_t xCounters;
+
+    (void)xTimelineSchedulerGetTaskCounters(1, &xCounters);
+    if (xCounters.ulOverruns != 1) {
+        snprintf(pcReason, xSize, "overrun count is %lu, expected 1", (unsigned long)xCounters.ulOverruns);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+// Case: windows separated by a single tick
+static const TimelineTaskConfig_t xGapTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobShort, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 21, .ulEndTimeTicks = 30, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xGap = { xGapTasks, TEST_COUNT_OF(xGapTasks), 0, 0, NULL };
+static const TestExpectation_t xGapExpected[] = {
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 21, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 26, 1 },
+};
+static const uint8_t ucGapForbidden[] = { TRACE_EVENT_RELEASE_SKIPPED };
+
+// Case: back-to-back windows; the deadline is enforced before the next release
+static const TimelineTaskConfig_t xAdjacentTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobShort, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 20, .ulEndTimeTicks = 30, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xAdjacent = { xAdjacentTasks, TEST_COUNT_OF(xAdjacentTasks), 0, 0, NULL };
+static const TestExpectation_t xAdjacentExpected[] = {
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 20, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 25, 1 },
+};
+
+// Case: a job finishing on the last tick of its window completes
+static const TimelineTaskConfig_t xLastTickTasks[] = {
+    { .pvTaskCode = prvJobNineTicks, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xLastTick = { xLastTickTasks, TEST_COUNT_OF(xLastTickTasks), 0, 0, NULL };
+static const TestExpectation_t xLastTickExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 19, 0 },
+};
+
+// Case: a job finishing exactly at its deadline is too late; windows are [start, end)
+static const TimelineTaskConfig_t xAtDeadlineTasks[] = {
+    { .pvTaskCode = prvJobTenTicks, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xAtDeadline = { xAtDeadlineTasks, TEST_COUNT_OF(xAtDeadlineTasks), 0, 0, NULL };
+static const TestExpectation_t xAtDeadlineExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+};
+static const uint8_t ucAtDeadlineForbidden[] = { TRACE_EVENT_TASK_COMPLETE };
+
+// Case: after a miss, TIMELINE_MISS_SKIP drops the next release
+static const TimelineTaskConfig_t xMissSkipTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .xMissPolicy = TIMELINE_MISS_SKIP,
+      .ulMissSkipReleases = 1 },
+};
+static const TimelineConfig_t xMissSkip = { xMissSkipTasks, TEST_COUNT_OF(xMissSkipTasks), 0, 0, NULL };
+static const TestExpectation_t xMissSkipExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_RELEASE_SKIPPED, 0, 110, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 210, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 220, 0 },
+};
+
+static BaseType_t prvCheckMissSkip(char *pcReason, size_t xSize) {
+    TimelineTaskCounters_t xCounters;
+
+    (void)xTimelineSchedulerGetTaskCounters(0, &xCounters);
+    if (xCounters.ulMisses != 2 || xCounters.ulPolicySkips != 1 || xCounters.ulOverruns != 0) {
+        snprintf(pcReason, xSize, "%lu misses, %lu skips, %lu overruns; expected 2, 1, 0",
+                 (unsigned long)xCounters.ulMisses, (unsigned long)xCounters.ulPolicySkips,
+                 (unsigned long)xCounters.ulOverruns);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+// Case: after a miss, TIMELINE_MISS_DEGRADE runs the alternate handler until a job completes
+static const TimelineTaskConfig_t xMissDegradeTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .xMissPolicy = TIMELINE_MISS_DEGRADE,
+      .pvDegradedCode = prvJobShort },
+};
+static const TimelineConfig_t xMissDegrade = { xMissDegradeTasks, TEST_COUNT_OF(xMissDegradeTasks), 0, 0, NULL };
+static const TestExpectation_t xMissDegradeExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 115, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 210, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 220, 0 },
+};
+
+static BaseType_t prvCheckMissDegrade(char *pcReason, size_t xSize) {
+    TimelineTaskCounters_t xCounters;
+
+    (void)xTimelineSchedulerGetTaskCounters(0, &xCounters);
+    if (xCounters.ulMisses != 2 || xCounters.ulDegradedRuns != 1) {
+        snprintf(pcReason, xSize, "%lu misses, %lu degraded runs; expected 2, 1",
+                 (unsigned long)xCounters.ulMisses, (unsigned long)xCounters.ulDegradedRuns);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+// Case: TIMELINE_MISS_ESCALATE hands every miss to the application hook
+static const TimelineTaskConfig_t xMissEscalateTasks[] = {
+    { .pvTaskCode = prvJobEndless, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .xMissPolicy = TIMELINE_MISS_ESCALATE },
+};
+static const TimelineConfig_t xMissEscalate = { xMissEscalateTasks, TEST_COUNT_OF(xMissEscalateTasks), 0, 0, NULL };
+static const TestExpectation_t xMissEscalateExpected[] = {
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 120, 0 },
+};
+
+static void prvSetupMissEscalate(void) {
+    ulDeadlineHookCalls = 0;
+}
+
+static BaseType_t prvCheckMissEscalate(char *pcReason, size_t xSize) {
+    if (ulDeadlineHookCalls != 2) {
+        snprintf(pcReason, xSize, "hook called %lu times, expected 2", (unsigned long)ulDeadlineHookCalls);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+#endif
+
+#if (TIMELINE_ABORT_LEAD_TICKS > 0) && (TIMELINE_ABORT_LEAD_TICKS < 20)
+// Case: a job asked to stop ahead of its deadline returns by itself and is not killed
+static const TimelineTaskConfig_t xAbortTasks[] = {
+    { .pvTaskCode = prvJobUntilAbort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 30, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xAbort = { xAbortTasks, TEST_COUNT_OF(xAbortTasks), 0, 0, NULL };
+static const TestExpectation_t xAbortExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_ABORT_REQUEST, 0, 30 - TIMELINE_ABORT_LEAD_TICKS, 0 },
+    { TRACE_EVENT_JOB_ABORTED, 0, 30 - TIMELINE_ABORT_LEAD_TICKS, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+    { TRACE_EVENT_JOB_ABORTED, 0, 130 - TIMELINE_ABORT_LEAD_TICKS, 1 },
+};
+static const uint8_t ucAbortForbidden[] = { TRACE_EVENT_DEADLINE_MISS, TRACE_EVENT_TASK_COMPLETE };
+#endif
+
+// Case: a mutex held by a killed job is released when the job is reclaimed
+static const TimelineTaskConfig_t xMutexKillTasks[] = {
+    { .pvTaskCode = prvJobHoldMutex, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xMutexKill = { xMutexKillTasks, TEST_COUNT_OF(xMutexKillTasks), 0, 0, NULL };
+static const TestExpectation_t xMutexKillExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_JOB_RECLAIMED, 0, 20, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 120, 0 },
+    { TRACE_EVENT_JOB_RECLAIMED, 0, 120, 1 },
+};
+
+static void prvSetupMutexKill(void) {
+    vTimelineMutexInit(&xTestMutex);
+    ulMutexTakes = 0;
+}
+
+static BaseType_t prvCheckMutexKill(char *pcReason, size_t xSize) {
+    if (ulMutexTakes != 2) {
+        snprintf(pcReason, xSize, "mutex taken by %lu jobs, expected 2", (unsigned long)ulMutexTakes);
+        return pdFAIL;
+    }
+    if (xTimelineMutexTake(&xTestMutex, 0) != pdPASS) {
+        snprintf(pcReason, xSize, "mutex still held after the kill");
+        return pdFAIL;
+    }
+    (void)xTimelineMutexGive(&xTestMutex);
+    return pdPASS;
+}
+
+// Case: data passed through channels; the writes of a killed producer never show
+static const TimelineTaskConfig_t xChannelTasks[] = {
+    { .pvTaskCode = prvJobProducer, .pcName = "P", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobConsumer, .pcName = "C", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 60, .ulEndTimeTicks = 70, .ulSubframeId = 1 },
+};
+static const TimelineConfig_t xChannel = { xChannelTasks, TEST_COUNT_OF(xChannelTasks), 0, 0, NULL };
+static const TestExpectation_t xChannelExpected[] = {
+    { TRACE_EVENT_DEADLINE_MISS, 0, 20, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 60, 1 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 120, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 160, 1 },
+};
+
+static void prvSetupChannel(void) {
+    ulChannelReads = 0;
+    ulChannelMessages = 0;
+    ulChannelErrors = 0;
+}
+
+static BaseType_t prvCheckChannel(char *pcReason, size_t xSize) {
+    if (ulChannelReads != 2 || ulChannelMessages != 4 || ulChannelErrors != 0) {
+        snprintf(pcReason, xSize, "%lu reads, %lu messages, %lu errors; expected 2, 4, 0",
+                 (unsigned long)ulChannelReads, (unsigned long)ulChannelMessages, (unsigned long)ulChannelErrors);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+// Case: a state channel stays whole while its producer is killed ten times a frame and its consumer once
+static const TimelineTaskConfig_t xChannelKillTasks[] = {
+    { .pvTaskCode = prvJobKillProducer, .pcName = "P", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 2, .ulEndTimeTicks = 4, .ulPeriodTicks = 10 },
+    { .pvTaskCode = prvJobKillConsumer, .pcName = "C", .xTaskType = TASK_TYPE_SOFT_RT },
+};
+static const TimelineConfig_t xChannelKill = { xChannelKillTasks, TEST_COUNT_OF(xChannelKillTasks), 0, 0, NULL };
+
+static void prvSetupChannelKill(void) {
+    ulKillReads = 0;
+    ulKillTorn = 0;
+    ulKillGapTicks = 0;
+    ulKillLastSeen = ulKillSequence;
+    xKillGapCheck = pdTRUE;
+}
+
+static BaseType_t prvCheckChannelKill(char *pcReason, size_t xSize) {
+    UBaseType_t uxProducerKills = 0;
+    UBaseType_t uxConsumerKills = 0;
+
+    xKillGapCheck = pdFALSE;
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        if (xCaptured[i].ucEvent == TRACE_EVENT_DEADLINE_MISS && xCaptured[i].usTaskId == 0) {
+            uxProducerKills++;
+        } else if (xCaptured[i].ucEvent == TRACE_EVENT_SRT_INCOMPLETE && xCaptured[i].usTaskId == 1) {
+            uxConsumerKills++;
+        }
+    }
+    // The settling ticks reach into a third frame, which may add a few more
+    if (uxProducerKills < 20 || uxConsumerKills < 2) {
+        snprintf(pcReason, xSize, "%lu producer and %lu consumer kills, expected at least 20 and 2",
+                 (unsigned long)uxProducerKills, (unsigned long)uxConsumerKills);
+        return pdFAIL;
+    }
+    if (ulKillReads == 0 || ulKillTorn != 0 || ulKillGapTicks != 0) {
+        snprintf(pcReason, xSize, "%lu reads, %lu torn, %lu ticks in a handover; expected some, 0, 0",
+                 (unsigned long)ulKillReads, (unsigned long)ulKillTorn, (unsigned long)ulKillGapTicks);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+// Case: registered state blocks are restored at every frame start, before the first release
+static const TimelineTaskConfig_t xStateResetTasks[] = {
+    { .pvTaskCode = prvJobMutateState, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xStateReset = { xStateResetTasks, TEST_COUNT_OF(xStateResetTasks), 0, 0, NULL };
+static const TestExpectation_t xStateResetExpected[] = {
+    { TRACE_EVENT_STATE_RESET, SCHED, 0, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 10, 1 },
+    { TRACE_EVENT_STATE_RESET, SCHED, 100, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 110, 1 },
+};
+
+static void prvSetupStateReset(void) {
+    ulStateErrors = 0;
+    (void)xTimelineStateRegister(&xTestFrameState, &xTestFrameStateImage, sizeof(xTestFrameState));
+    (void)xTimelineStateRegister(ulTestScratch, NULL, sizeof(ulTestScratch));
+}
+
+static BaseType_t prvCheckStateReset(char *pcReason, size_t xSize) {
+    if (ulStateErrors != 0) {
+        snprintf(pcReason, xSize, "%lu jobs saw a state left by an earlier frame", (unsigned long)ulStateErrors);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+// Case: a window given in microseconds on the tick grid behaves like its tick equivalent
+static const TimelineTaskConfig_t xMicrosecondTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeUs = 10000, .ulEndTimeUs = 20000, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xMicrosecond = { xMicrosecondTasks, TEST_COUNT_OF(xMicrosecondTasks), 0, 0, NULL };
+static const TestExpectation_t xMicrosecondExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 15, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 110, 0 },
+};
+
+// Case: jobs allocate from the frame arena, which is rewound before the next frame
+static const TimelineTaskConfig_t xArenaTasks[] = {
+    { .pvTaskCode = prvJobArenaFirst, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+    { .pvTaskCode = prvJobArenaSecond, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 60, .ulEndTimeTicks = 70, .ulSubframeId = 1 },
+};
+static const TimelineConfig_t xArena = { xArenaTasks, TEST_COUNT_OF(xArenaTasks), 0, 0, NULL };
+static const TestExpectation_t xArenaExpected[] = {
+    { TRACE_EVENT_TASK_COMPLETE, 0, 10, 1 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 60, 1 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 110, 1 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 160, 1 },
+};
+
+static void prvSetupArena(void) {
+    pucArenaStart = NULL;
+    pucArenaNext = NULL;
+    ulArenaErrors = 0;
+}
+
+static BaseType_t prvCheckArena(char *pcReason, size_t xSize) {
+    TimelineArenaStats_t xStats;
+#if (TIMELINE_ARENA_PER_SUBFRAME == 1)
+    const size_t xPeak = TEST_ARENA_ROUND(3) + TEST_ARENA_ROUND(100);
+#else
+    const size_t xPeak = TEST_ARENA_ROUND(3) + TEST_ARENA_ROUND(100) + TEST_ARENA_ROUND(40);
+#endif
+
+    vTimelineArenaGetStats(&xStats);
+    if (ulArenaErrors != 0) {
+        snprintf(pcReason, xSize, "%lu jobs got memory at the wrong place", (unsigned long)ulArenaErrors);
+        return pdFAIL;
+    }
+    if (xStats.ulAllocations != 6 || xStats.ulFailures != 2 || xStats.xHighWater != xPeak || xStats.ulResets == 0) {
+        snprintf(pcReason, xSize, "stats: %lu allocations, %lu failures, peak %lu of %lu, %lu resets",
+                 (unsigned long)xStats.ulAllocations, (unsigned long)xStats.ulFailures,
+                 (unsigned long)xStats.xHighWater, (unsigned long)xPeak, (unsigned long)xStats.ulResets);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_STACK_PROFILING == 1)
+// Case: the stack use of a job is profiled when it completes and when it is killed
+static const TimelineTaskConfig_t xStackProfileTasks[] = {
+    { .pvTaskCode = prvJobUseStack, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .ulStackDepth = TEST_STACK_DEPTH },
+    { .pvTaskCode = prvJobUseStackEndless, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 60, .ulEndTimeTicks = 70, .ulSubframeId = 1, .ulStackDepth = TEST_STACK_DEPTH },
+};
+static const TimelineConfig_t xStackProfile = { xStackProfileTasks, TEST_COUNT_OF(xStackProfileTasks), 0, 0, NULL };
+static const TestExpectation_t xStackProfileExpected[] = {
+    { TRACE_EVENT_TASK_COMPLETE, 0, 10, 1 },
+    { TRACE_EVENT_DEADLINE_MISS, 1, 70, 0 },
+};
+
+static BaseType_t prvCheckStackProfile(char *pcReason, size_t xSize) {
+    static const char *const pcEnds[] = { "completed", "killed" };
+
+    for (UBaseType_t i = 0; i < TEST_COUNT_OF(pcEnds); i++) {
+        TimelineTaskStats_t xStats;
+
+        if (xTimelineStatsGetTask(i, &xStats) != pdPASS) {
+            snprintf(pcReason, xSize, "no statistics for the %s job", pcEnds[i]);
+            return pdFAIL;
+        }
+        if (xStats.ulStackDepth != TEST_STACK_DEPTH || xStats.ulStackPeakWords == 0 ||
+            xStats.ulStackPeakWords > TEST_STACK_DEPTH) {
+            snprintf(pcReason, xSize, "%s job: stack %lu/%lu, expected 1 to %lu of %lu", pcEnds[i],
+                     (unsigned long)xStats.ulStackPeakWords, (unsigned long)xStats.ulStackDepth,
+                     (unsigned long)TEST_STACK_DEPTH, (unsigned long)TEST_STACK_DEPTH);
+            return pdFAIL;
+        }
+    }
+    return pdPASS;
+}
+#endif
+
+// Case: a declared timeline runs from its const table; B is too short for the default abort lead
+#define TEST_DECLARED_TIMELINE(SUBFRAME, HRT, SRT)                                         \
+    SUBFRAME(0, 0, 50)                                                                     \
+    HRT(DeclaredA, prvJobShort, 0, 10, 20, 0, TIMELINE_MISS_KILL, 0, NULL)                 \
+    SUBFRAME(1, 50, 100)                                                                   \
+    HRT(DeclaredB, prvJobNop, 1, 60, 62, 0, TIMELINE_MISS_KILL, 0, NULL)
+TIMELINE_DEFINE(xDeclared, TEST_DECLARED_TIMELINE);
+static const TestExpectation_t xDeclaredExpected[] = {
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 0, 0 },
+    { TRACE_EVENT_TASK_SPAWN, TIMELINE_ID_DeclaredA, 10, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, TIMELINE_ID_DeclaredA, 15, 1 },
+    { TRACE_EVENT_SUBFRAME_START, SCHED, 50, 0 },
+    { TRACE_EVENT_TASK_SPAWN, TIMELINE_ID_DeclaredB, 60, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, TIMELINE_ID_DeclaredB, 60, 1 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 100, 0 },
+    { TRACE_EVENT_TASK_SPAWN, TIMELINE_ID_DeclaredA, 110, 0 },
+};
+
+// Case: MAX_TASKS tasks, two of them SRT; the table is built at run time
+static TimelineTaskConfig_t xFullLoadTasks[MAX_TASKS];
+static const TimelineConfig_t xFullLoad = { xFullLoadTasks, MAX_TASKS, 0, 0, NULL };
+static const uint8_t ucFullLoadForbidden[] = {
+    TRACE_EVENT_DEADLINE_MISS, TRACE_EVENT_RELEASE_SKIPPED, TRACE_EVENT_FRAME_OVERRUN,
+    TRACE_EVENT_TASK_CREATE_FAILED, TRACE_EVENT_SRT_INCOMPLETE,
+};
+
+static void prvBuildFullLoad(void) {
+    const UBaseType_t uxHard = MAX_TASKS - 2;
+    const UBaseType_t uxPerSubframe = (uxHard + SUBFRAMES_PER_MAJOR_FRAME - 1) / SUBFRAMES_PER_MAJOR_FRAME;
+    const uint32_t ulSlot = SUBFRAME_DURATION_TICKS / uxPerSubframe;
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; i++) {
+        TimelineTaskConfig_t *pxTask = &xFullLoadTasks[i];
+
+        pxTask->pvTaskCode = prvJobNop;
+        pxTask->pcName = "Load";
+        if (i < uxHard) {
+            uint32_t ulSubframe = i / uxPerSubframe;
+
+            pxTask->xTaskType = TASK_TYPE_HARD_RT;
+            pxTask->ulSubframeId = ulSubframe;
+            pxTask->ulStartTimeTicks = ulSubframe * SUBFRAME_DURATION_TICKS + (i % uxPerSubframe) * ulSlot;
+            pxTask->ulEndTimeTicks = pxTask->ulStartTimeTicks + ulSlot - 1;
+        } else {
+            pxTask->xTaskType = TASK_TYPE_SOFT_RT;
+            pxTask->ulSubframeId = 0;
+            pxTask->ulStartTimeTicks = 0;
+            pxTask->ulEndTimeTicks = 0;
+        }
+    }
+}
+
+static BaseType_t prvCheckFullLoad(char *pcReason, size_t xSize) {
+    uint32_t ulSpawned[MAX_TASKS] = {0};
+    uint32_t ulCompleted[MAX_TASKS] = {0};
+
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        if (xCaptured[i].usTaskId >= MAX_TASKS) {
+            continue;
+        }
+        if (xCaptured[i].ucEvent == TRACE_EVENT_TASK_SPAWN) {
+            ulSpawned[xCaptured[i].usTaskId]++;
+        } else if (xCaptured[i].ucEvent == TRACE_EVENT_TASK_COMPLETE) {
+            ulCompleted[xCaptured[i].usTaskId]++;
+        }
+    }
+
+    for (UBaseType_t i = 0; i < MAX_TASKS; i++) {
+        if (ulSpawned[i] < 2 || ulCompleted[i] < 2) {
+            snprintf(pcReason, xSize, "task %lu spawned %lu and completed %lu times in 2 frames",
+                     (unsigned long)i, (unsigned long)ulSpawned[i], (unsigned long)ulCompleted[i]);
+            return pdFAIL;
+        }
+    }
+    return pdPASS;
+}
+
+// Case: an HRT release preempts the running SRT job, which resumes afterwards
+static const TimelineTaskConfig_t xPreemptTasks[] = {
+    { .pvTaskCode = prvJobBusy, .pcName = "S", .xTaskType = TASK_TYPE_SOFT_RT },
+    { .pvTaskCode = prvJobShort, .pcName = "H", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xPreempt = { xPreemptTasks, TEST_COUNT_OF(xPreemptTasks), 0, 0, NULL };
+static const TestExpectation_t xPreemptExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 0, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 10, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 1, 15, 1 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 30, 1 },
+};
+
+// Case: one entry released every 25 ticks; the second instance is only admitted against its own deadline
+static const TimelineTaskConfig_t xMultiRateTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 5, .ulEndTimeTicks = 15, .ulPeriodTicks = 25 },
+    { .pvTaskCode = prvJobNop, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 40, .ulEndTimeTicks = 48, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xMultiRate = { xMultiRateTasks, TEST_COUNT_OF(xMultiRateTasks), 0, 0, NULL };
+static const TestExpectation_t xMultiRateExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 5, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 10, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 30, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 35, 1 },
+    { TRACE_EVENT_TASK_SPAWN, 1, 40, 0 },
+    { TRACE_EVENT_SUBFRAME_START, SCHED, 50, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 55, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 80, 0 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 100, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 105, 0 },
+};
+
+static BaseType_t prvCheckMultiRate(char *pcReason, size_t xSize) {
+    UBaseType_t uxSpawns = 0;
+    uint8_t ucRunning = 0;
+
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        const TraceRecord_t *pxRecord = &xCaptured[i];
+        uint8_t ucExpected;
+
+        if (pxRecord->usTaskId != 0) {
+            ucExpected = 0;
+        } else if (pxRecord->ucEvent == TRACE_EVENT_TASK_SPAWN) {
+            ucExpected = (uint8_t)(uxSpawns++ % 4);
+            ucRunning = ucExpected;
+        } else {
+            ucExpected = ucRunning;
+        }
+        if (pxRecord->ucInstance != ucExpected) {
+            snprintf(pcReason, xSize, "event %u of task %u at tick %lu has instance %u, expected %u",
+                     (unsigned)pxRecord->ucEvent, (unsigned)pxRecord->usTaskId, (unsigned long)pxRecord->ulTick,
+                     (unsigned)pxRecord->ucInstance, (unsigned)ucExpected);
+            return pdFAIL;
+        }
+    }
+    if (uxSpawns < 8) {
+        snprintf(pcReason, xSize, "%lu releases in 2 frames, expected 8", (unsigned long)uxSpawns);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+#if (TIMELINE_TICK_DISPATCH == 0)
+// Case: the scheduler is held past the frame boundary and reports the overrun; there is
+// no scheduler task to hold when the timeline is dispatched from the tick
+static const TimelineTaskConfig_t xOverrunTasks[] = {
+    { .pvTaskCode = prvJobStallScheduler, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xOverrun = { xOverrunTasks, TEST_COUNT_OF(xOverrunTasks), 0, 0, NULL };
+static const TestExpectation_t xOverrunExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_DEADLINE_MISS, 0, 130, 1 },
+    { TRACE_EVENT_FRAME_OVERRUN, SCHED, 130, 1 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 130, 1 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 200, 0 },
+};
+
+static void prvSetupOverrun(void) {
+    xStallDone = pdFALSE;
+}
+
+static BaseType_t prvCheckOverrun(char *pcReason, size_t xSize) {
+    if (ulTimelineSchedulerGetFrameOverrunCount() != 1) {
+        snprintf(pcReason, xSize, "overrun count is %lu, expected 1",
+                 (unsigned long)ulTimelineSchedulerGetFrameOverrunCount());
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+#endif
+
+// Case: a switch requested mid-frame takes effect at the boundary, with the new frame layout
+static const TimelineTaskConfig_t xSwitchFromTasks[] = {
+    { .pvTaskCode = prvJobRequestSwitch, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xSwitchFrom = { xSwitchFromTasks, TEST_COUNT_OF(xSwitchFromTasks), 0, 0, NULL };
+static const TimelineTaskConfig_t xSwitchToTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "B", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 30, .ulEndTimeTicks = 40, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xSwitchTo = { xSwitchToTasks, TEST_COUNT_OF(xSwitchToTasks), 50, 50, NULL };
+static const TestExpectation_t xSwitchExpected[] = {
+    { TRACE_EVENT_TASK_SPAWN, 0, 10, 0 },
+    { TRACE_EVENT_SWITCH_REQUEST, SCHED, 10, 1 },
+    { TRACE_EVENT_SCHEDULE_SWITCH, SCHED, 100, 0 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 100, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 130, 0 },
+    { TRACE_EVENT_TASK_COMPLETE, 0, 135, 1 },
+    { TRACE_EVENT_MAJOR_FRAME_START, SCHED, 150, 0 },
+    { TRACE_EVENT_TASK_SPAWN, 0, 180, 0 },
+};
+
+static void prvSetupSwitch(void) {
+    (void)xTimelineSchedulerRegister(&xSwitchTo, &uxSwitchTarget);
+}
+
+static BaseType_t prvCheckSwitch(char *pcReason, size_t xSize) {
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        if (xCaptured[i].ucEvent == TRACE_EVENT_SCHEDULE_SWITCH && xCaptured[i].ulArg != 90) {
+            snprintf(pcReason, xSize, "switch took %lu ticks, expected 90", (unsigned long)xCaptured[i].ulArg);
+            return pdFAIL;
+        }
+    }
+    return pdPASS;
+}
+
+// Cases: invalid configurations are rejected by init
+static const TimelineTaskConfig_t xStraddleTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 40, .ulEndTimeTicks = 60, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xStraddle = { xStraddleTasks, TEST_COUNT_OF(xStraddleTasks), 0, 0, NULL };
+
+static const TimelineTaskConfig_t xTooManyTasks[MAX_TASKS + 1] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_SOFT_RT },
+};
+static const TimelineConfig_t xTooMany = { xTooManyTasks, MAX_TASKS + 1, 0, 0, NULL };
+
+static const TimelineTaskConfig_t xBadPeriodTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 5, .ulEndTimeTicks = 15, .ulPeriodTicks = 30 },
+};
+static const TimelineConfig_t xBadPeriod = { xBadPeriodTasks, TEST_COUNT_OF(xBadPeriodTasks), 0, 0, NULL };
+
+#if (TIMELINE_ONESHOT_TIMER == 0)
+static const TimelineTaskConfig_t xOffGridTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeUs = 10500, .ulEndTimeUs = 20000, .ulSubframeId = 0 },
+};
+static const TimelineConfig_t xOffGrid = { xOffGridTasks, TEST_COUNT_OF(xOffGridTasks), 0, 0, NULL };
+#endif
+
+static const TimelineTaskConfig_t xNoDegradedTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .xMissPolicy = TIMELINE_MISS_DEGRADE },
+};
+static const TimelineConfig_t xNoDegraded = { xNoDegradedTasks, TEST_COUNT_OF(xNoDegradedTasks), 0, 0, NULL };
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 0)
+static const TimelineTaskConfig_t xNoHookTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_HARD_RT,
+      .ulStartTimeTicks = 10, .ulEndTimeTicks = 20, .ulSubframeId = 0, .xMissPolicy = TIMELINE_MISS_ESCALATE },
+};
+static const TimelineConfig_t xNoHook = { xNoHookTasks, TEST_COUNT_OF(xNoHookTasks), 0, 0, NULL };
+#endif
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+static const TimelineTaskConfig_t xStackTooBigTasks[] = {
+    { .pvTaskCode = prvJobShort, .pcName = "A", .xTaskType = TASK_TYPE_SOFT_RT,
+      .ulStackDepth = TIMELINE_STACK_ARENA_WORDS + 1 },
+};
+static const TimelineConfig_t xStackTooBig = { xStackTooBigTasks, TEST_COUNT_OF(xStackTooBigTasks), 0, 0, NULL };
+#endif
+
+static const TestCase_t xTestCases[] = {
+    { "Nominal windows", &xNominal, pdFALSE, 2, xNominalExpected, TEST_COUNT_OF(xNominalExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), NULL, NULL },
+    { "Overlapping HRT windows", &xOverlap, pdFALSE, 1, xOverlapExpected, TEST_COUNT_OF(xOverlapExpected),
+      NULL, 0, NULL, prvCheckOverlap },
+    { "One-tick gap", &xGap, pdFALSE, 1, xGapExpected, TEST_COUNT_OF(xGapExpected),
+      ucGapForbidden, TEST_COUNT_OF(ucGapForbidden), NULL, NULL },
+    { "Back-to-back windows", &xAdjacent, pdFALSE, 1, xAdjacentExpected, TEST_COUNT_OF(xAdjacentExpected),
+      ucGapForbidden, TEST_COUNT_OF(ucGapForbidden), NULL, NULL },
+    { "Completion on last tick", &xLastTick, pdFALSE, 1, xLastTickExpected, TEST_COUNT_OF(xLastTickExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), NULL, NULL },
+    { "Completion at deadline", &xAtDeadline, pdFALSE, 1, xAtDeadlineExpected, TEST_COUNT_OF(xAtDeadlineExpected),
+      ucAtDeadlineForbidden, TEST_COUNT_OF(ucAtDeadlineForbidden), NULL, NULL },
+    { "Skip policy", &xMissSkip, pdFALSE, 3, xMissSkipExpected, TEST_COUNT_OF(xMissSkipExpected),
+      NULL, 0, NULL, prvCheckMissSkip },
+    { "Degrade policy", &xMissDegrade, pdFALSE, 3, xMissDegradeExpected, TEST_COUNT_OF(xMissDegradeExpected),
+      NULL, 0, NULL, prvCheckMissDegrade },
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+    { "Escalate policy", &xMissEscalate, pdFALSE, 2, xMissEscalateExpected, TEST_COUNT_OF(xMissEscalateExpected),
+      NULL, 0, prvSetupMissEscalate, prvCheckMissEscalate },
+#endif
+#if (TIMELINE_ABORT_LEAD_TICKS > 0) && (TIMELINE_ABORT_LEAD_TICKS < 20)
+    { "Cooperative abort", &xAbort, pdFALSE, 2, xAbortExpected, TEST_COUNT_OF(xAbortExpected),
+      ucAbortForbidden, TEST_COUNT_OF(ucAbortForbidden), NULL, NULL },
+#endif
+    { "Mutex released on kill", &xMutexKill, pdFALSE, 2, xMutexKillExpected, TEST_COUNT_OF(xMutexKillExpected),
+      NULL, 0, prvSetupMutexKill, prvCheckMutexKill },
+    { "Channels between jobs", &xChannel, pdFALSE, 2, xChannelExpected, TEST_COUNT_OF(xChannelExpected),
+      NULL, 0, prvSetupChannel, prvCheckChannel },
+    { "State channel across kills", &xChannelKill, pdFALSE, 2, NULL, 0,
+      NULL, 0, prvSetupChannelKill, prvCheckChannelKill },
+    { "Frame state reset", &xStateReset, pdFALSE, 2, xStateResetExpected, TEST_COUNT_OF(xStateResetExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), prvSetupStateReset, prvCheckStateReset },
+    { "Microsecond window", &xMicrosecond, pdFALSE, 2, xMicrosecondExpected, TEST_COUNT_OF(xMicrosecondExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), NULL, NULL },
+    { "Frame arena", &xArena, pdFALSE, 2, xArenaExpected, TEST_COUNT_OF(xArenaExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), prvSetupArena, prvCheckArena },
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_STACK_PROFILING == 1)
+    { "Stack profiling", &xStackProfile, pdFALSE, 1, xStackProfileExpected, TEST_COUNT_OF(xStackProfileExpected),
+      NULL, 0, NULL, prvCheckStackProfile },
+#endif
+    { "Declared timeline", &xDeclared, pdFALSE, 2, xDeclaredExpected, TEST_COUNT_OF(xDeclaredExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), NULL, NULL },
+    { "Full MAX_TASKS load", &xFullLoad, pdFALSE, 2, NULL, 0,
+      ucFullLoadForbidden, TEST_COUNT_OF(ucFullLoadForbidden), prvBuildFullLoad, prvCheckFullLoad },
+    { "SRT preemption", &xPreempt, pdFALSE, 1, xPreemptExpected, TEST_COUNT_OF(xPreemptExpected),
+      NULL, 0, NULL, NULL },
+    { "Multi-rate task", &xMultiRate, pdFALSE, 2, xMultiRateExpected, TEST_COUNT_OF(xMultiRateExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), NULL, prvCheckMultiRate },
+#if (TIMELINE_TICK_DISPATCH == 0)
+    { "Frame overrun", &xOverrun, pdFALSE, 2, xOverrunExpected, TEST_COUNT_OF(xOverrunExpected),
+      NULL, 0, prvSetupOverrun, prvCheckOverrun },
+#endif
+    { "Schedule switch", &xSwitchFrom, pdFALSE, 2, xSwitchExpected, TEST_COUNT_OF(xSwitchExpected),
+      ucNoMisses, TEST_COUNT_OF(ucNoMisses), prvSetupSwitch, prvCheckSwitch },
+    { "Window straddling sub-frames", &xStraddle, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+    { "More than MAX_TASKS tasks", &xTooMany, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+    { "Period not dividing the frame", &xBadPeriod, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+#if (TIMELINE_ONESHOT_TIMER == 0)
+    { "Microsecond window off the tick grid", &xOffGrid, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+#endif
+    { "Degrade policy without a handler", &xNoDegraded, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+#if (TIMELINE_USE_DEADLINE_HOOK == 0)
+    { "Escalate policy without the hook", &xNoHook, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+#endif
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    { "Stacks exceeding the arena", &xStackTooBig, pdTRUE, 0, NULL, 0, NULL, 0, NULL, NULL },
+#endif
+};
+
+// --- Private Functions ---
+
+/**
+ * @brief Trace record hook: stores every event of the running case.
+ */
+static void prvCaptureRecord(const TraceRecord_t *pxRecord) {
+    if (xCaptureEnabled != pdFALSE && uxCaptured < TEST_CAPTURE_LENGTH) {
+        xCaptured[uxCaptured++] = *pxRecord;
+    }
+}
+
+static const char *prvEventName(uint8_t ucEvent) {
+    return (ucEvent < TEST_COUNT_OF(pcEventNames)) ? pcEventNames[ucEvent] : "?";
+}
+
+/**
+ * @brief Checks the captured events of a case.
+ *
+ * @return pdPASS, or pdFAIL with the reason written to pcReason.
+ */
+static BaseType_t prvEvaluate(const TestCase_t *pxCase, char *pcReason, size_t xSize) {
+    UBaseType_t uxBase = uxCaptured;
+    UBaseType_t uxNext;
+
+    // Offsets are relative to the start of the first frame
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        if (xCaptured[i].ucEvent == TRACE_EVENT_MAJOR_FRAME_START) {
+            uxBase = i;
+            break;
+        }
+    }
+    if (uxBase == uxCaptured) {
+        snprintf(pcReason, xSize, "no frame started");
+        return pdFAIL;
+    }
+    uxNext = uxBase;
+
+    for (UBaseType_t e = 0; e < pxCase->uxExpected; e++) {
+        const TestExpectation_t *pxExp = &pxCase->pxExpected[e];
+        uint32_t ulExpectedTick = xCaptured[uxBase].ulTick + pxExp->ulOffset;
+
+        while (uxNext < uxCaptured &&
+               (xCaptured[uxNext].ucEvent != pxExp->ucEvent || xCaptured[uxNext].usTaskId != pxExp->usTaskId)) {
+            uxNext++;
+        }
+        if (uxNext == uxCaptured) {
+            snprintf(pcReason, xSize, "missing %s of task %u at +%lu", prvEventName(pxExp->ucEvent),
+                     (unsigned)pxExp->usTaskId, (unsigned long)pxExp->ulOffset);
+            return pdFAIL;
+        }
+
+        int32_t lDelta = (int32_t)(xCaptured[uxNext].ulTick - ulExpectedTick);
+        if (lDelta > (int32_t)pxExp->ulTolerance || -lDelta > (int32_t)pxExp->ulTolerance) {
+            snprintf(pcReason, xSize, "%s of task %u at +%ld, expected +%lu +/-%lu", prvEventName(pxExp->ucEvent),
+                     (unsigned)pxExp->usTaskId, (long)(xCaptured[uxNext].ulTick - xCaptured[uxBase].ulTick),
+                     (unsigned long)pxExp->ulOffset, (unsigned long)pxExp->ulTolerance);
+            return pdFAIL;
+        }
+        uxNext++;
+    }
+
+    for (UBaseType_t i = 0; i < uxCaptured; i++) {
+        for (UBaseType_t f = 0; f < pxCase->uxForbidden; f++) {
+            if (xCaptured[i].ucEvent == pxCase->pucForbidden[f]) {
+                snprintf(pcReason, xSize, "unexpected %s of task %u at +%ld", prvEventName(xCaptured[i].ucEvent),
+                         (unsigned)xCaptured[i].usTaskId, (long)(xCaptured[i].ulTick - xCaptured[uxBase].ulTick));
+                return pdFAIL;
+            }
+        }
+    }
+
+    if (uxCaptured == TEST_CAPTURE_LENGTH) {
+        snprintf(pcReason, xSize, "capture buffer full");
+        return pdFAIL;
+    }
+
+    if (pxCase->pxCheck != NULL) {
+        return pxCase->pxCheck(pcReason, xSize);
+    }
+    return pdPASS;
+}
+
+/**
+ * @brief Runs one case and reports its result.
+ */
+static BaseType_t prvRunCase(UBaseType_t uxNumber, const TestCase_t *pxCase) {
+    char cReason[96] = "";
+    char cLine[160];
+    BaseType_t xResult;
+
+    if (pxCase->pvSetup != NULL) {
+        pxCase->pvSetup();
+    }
+
+    uxCaptured = 0;
+    xCaptureEnabled = pdTRUE;
+
+    if (xTimelineSchedulerInit(pxCase->pxConfig) != pdPASS) {
+        xCaptureEnabled = pdFALSE;
+        xResult = pxCase->xExpectInitFail ? pdPASS : pdFAIL;
+        snprintf(cReason, sizeof(cReason), "init failed");
+    } else if (pxCase->xExpectInitFail) {
+        vTimelineSchedulerStop();
+        xCaptureEnabled = pdFALSE;
+        xResult = pdFAIL;
+        snprintf(cReason, sizeof(cReason), "invalid configuration accepted");
+    } else {
+        vTaskDelay(pxCase->ulFrames * MAJOR_FRAME_DURATION_TICKS + TEST_SETTLE_TICKS);
+        vTimelineSchedulerStop();
+        xCaptureEnabled = pdFALSE;
+        xResult = prvEvaluate(pxCase, cReason, sizeof(cReason));
+    }
+
+    if (xResult == pdPASS) {
+        snprintf(cLine, sizeof(cLine), "Test %lu - %s: PASSED\r\n", (unsigned long)uxNumber, pxCase->pcName);
+    } else {
+        snprintf(cLine, sizeof(cLine), "Test %lu - %s: FAILED (%s)\r\n", (unsigned long)uxNumber, pxCase->pcName,
+                 cReason);
+    }
+    uart_puts(cLine);
+    return xResult;
+}
+
+/**
+ * @brief Ends the run with the given exit status.
+ */
+static void prvExit(int iStatus) {
+#if defined(TIMELINE_SIM)
+    fflush(stdout);
+    exit(iStatus);
+#else
+    // Semihosting SYS_EXIT; QEMU exits with 0 for ADP_Stopped_ApplicationExit
+    // and with 1 for any other reason
+    register uint32_t ulOperation __asm__("r0") = 0x18;
+    register uint32_t ulReason __asm__("r1") = (iStatus == 0) ? 0x20026 : 0x20023;
+
+    __asm__ volatile("bkpt 0xAB" : : "r"(ulOperation), "r"(ulReason) : "memory");
+    for (;;) {
+    }
+#endif
+}
+
+/**
+ * @brief Runs the whole catalogue, then exits.
+ */
+static void prvRunnerTask(void *pvParameters) {
+    UBaseType_t uxPassed = 0;
+    char cLine[64];
+
+    (void)pvParameters;
+
+    vTraceSetRecordHook(prvCaptureRecord);
+
+    for (UBaseType_t i = 0; i < TEST_COUNT_OF(xTestCases); i++) {
+        if (prvRunCase(i + 1, &xTestCases[i]) == pdPASS) {
+            uxPassed++;
+        }
+    }
+
+    snprintf(cLine, sizeof(cLine), "%lu/%lu tests passed\r\n", (unsigned long)uxPassed,
+             (unsigned long)TEST_COUNT_OF(xTestCases));
+    uart_puts(cLine);
+
+    // Let the trace drain task and the UART empty their buffers
+    vTaskDelay(pdMS_TO_TICKS(100));
+    prvExit((uxPassed == TEST_COUNT_OF(xTestCases)) ? 0 : 1);
+}
+
+// --- FreeRTOS Hooks ---
+
+/**
+ * @brief Provides the memory used by the Idle task.
+ *
+ * Required because configSUPPORT_STATIC_ALLOCATION is set to 1.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize) {
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @brief Drives the timeline from the kernel tick when TIMELINE_TICK_DISPATCH is set,
+ * and checks the channel of the kill case.
+ *
+ * Required because configUSE_TICK_HOOK is enabled.
+ */
+void vApplicationTickHook(void) {
+    vTimelineSchedulerTickHook();
+    prvCheckKillGap();
+}
+
+/**
+ * @brief Fails the run on a stack overflow, naming the task.
+ *
+ * Required because configCHECK_FOR_STACK_OVERFLOW is enabled.
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    vTimelineSchedulerReportStackOverflow(xTask, pcTaskName);
+    prvExit(1);
+}
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+/**
+ * @brief Counts the deadline misses escalated by the timeline.
+ *
+ * Required because TIMELINE_USE_DEADLINE_HOOK is enabled.
+ */
+void vApplicationTimelineDeadlineHook(UBaseType_t uxTaskIndex, const char *pcTaskName) {
+    (void)uxTaskIndex;
+    (void)pcTaskName;
+    ulDeadlineHookCalls++;
+}
+#endif
+
+int main(void) {
+    UART_init();
+    uart_puts("--- Timeline Scheduler Tests ---\r\n");
+
+    xTaskCreate(prvRunnerTask, "TestRunner", configMINIMAL_STACK_SIZE * 6, NULL, TEST_RUNNER_PRIORITY, NULL);
+    vTaskStartScheduler();
+
+    for (;;) {
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file timeline_arena.c
+ * @brief Implementation of the frame arena.
+ *
+ * The only shared state on the allocation path is the offset of the first
+ * free byte. Allocators advance it with a compare-and-swap, which only has to
+ * be repeated when a job or interrupt that preempted the caller allocated in
+ * between, and the scheduler rewinds it with a single atomic store. Worst-case
+ * latencies are kept with the cycle counter of timeline_stats.
+ */
+
+#include "timeline_arena.h"
+#include "timeline_stats.h"
+
+// --- Private State ---
+
+static uint8_t ucArena[TIMELINE_ARENA_BYTES] __attribute__((aligned(TIMELINE_ARENA_ALIGNMENT)));
+static size_t xArenaOffset = 0;       /**< First free byte, written by allocators and by the rewind. */
+
+static size_t xArenaLastPeriodUsed = 0;
+static size_t xArenaHighWater = 0;    /**< Largest complete period; the current one is added when read. */
+static uint32_t ulArenaAllocations = 0;
+static uint32_t ulArenaFailures = 0;
+static uint32_t ulArenaResets = 0;
+static uint32_t ulArenaAllocCyclesMax = 0;
+static uint32_t ulArenaResetCyclesMax = 0;
+
+// --- Private Functions ---
+
+#if (TIMELINE_ENABLE_STATS == 1)
+/**
+ * @brief Raises a worst-case figure that several contexts may update at once.
+ */
+static void prvArenaRecordMax(uint32_t *pulMax, uint32_t ulValue) {
+    uint32_t ulMax = __atomic_load_n(pulMax, __ATOMIC_RELAXED);
+
+    while (ulValue > ulMax &&
+           !__atomic_compare_exchange_n(pulMax, &ulMax, ulValue, pdFALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+#endif
+
+// --- Public API Implementation ---
+
+void *pvTimelineArenaAlloc(size_t xSize) {
+    const size_t xNeeded = (xSize + (TIMELINE_ARENA_ALIGNMENT - 1)) & ~(size_t)(TIMELINE_ARENA_ALIGNMENT - 1);
+    size_t xOffset = __atomic_load_n(&xArenaOffset, __ATOMIC_RELAXED);
+    void *pvMemory = NULL;
+#if (TIMELINE_ENABLE_STATS == 1)
+    const uint32_t ulStart = ulTimelineStatsGetCycles();
+#endif
+
+    // The rounding wraps around for sizes close to SIZE_MAX
+    if (xSize == 0 || xNeeded < xSize) {
+        return NULL;
+    }
+
+    // Bounded like the trace buffer: a retry means a preempting context allocated
+    do {
+        if (xNeeded > TIMELINE_ARENA_BYTES - xOffset) {
+            break;
+        }
+    } while (!__atomic_compare_exchange_n(&xArenaOffset, &xOffset, xOffset + xNeeded, pdFALSE,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (xNeeded <= TIMELINE_ARENA_BYTES - xOffset) {
+        pvMemory = &ucArena[xOffset];
+        (void)__atomic_fetch_add(&ulArenaAllocations, 1, __ATOMIC_RELAXED);
+    } else {
+        (void)__atomic_fetch_add(&ulArenaFailures, 1, __ATOMIC_RELAXED);
+#if (TIMELINE_USE_ARENA_HOOK == 1)
+        vApplicationTimelineArenaExhaustedHook(xSize, TIMELINE_ARENA_BYTES - xOffset);
+#endif
+    }
+
+#if (TIMELINE_ENABLE_STATS == 1)
+    prvArenaRecordMax(&ulArenaAllocCyclesMax, ulTimelineStatsGetCycles() - ulStart);
+#endif
+    return pvMemory;
+}
+
+size_t xTimelineArenaGetFree(void) {
+    return TIMELINE_ARENA_BYTES - __atomic_load_n(&xArenaOffset, __ATOMIC_RELAXED);
+}
+
+void vTimelineArenaReset(void) {
+#if (TIMELINE_ENABLE_STATS == 1)
+    const uint32_t ulStart = ulTimelineStatsGetCycles();
+#endif
+    size_t xUsed = __atomic_exchange_n(&xArenaOffset, 0, __ATOMIC_ACQ_REL);
+
+    xArenaLastPeriodUsed = xUsed;
+    if (xUsed > xArenaHighWater) {
+        xArenaHighWater = xUsed;
+    }
+    ulArenaResets++;
+
+#if (TIMELINE_ENABLE_STATS == 1)
+    prvArenaRecordMax(&ulArenaResetCyclesMax, ulTimelineStatsGetCycles() - ulStart);
+#endif
+}
+
+void vTimelineArenaGetStats(TimelineArenaStats_t *pxStats) {
+    if (pxStats == NULL) {
+        return;
+    }
+
+    pxStats->xSize = TIMELINE_ARENA_BYTES;
+    pxStats->xUsed = TIMELINE_ARENA_BYTES - xTimelineArenaGetFree();
+    pxStats->xLastPeriodUsed = xArenaLastPeriodUsed;
+    pxStats->xHighWater = (pxStats->xUsed > xArenaHighWater) ? pxStats->xUsed : xArenaHighWater;
+    pxStats->ulAllocations = __atomic_load_n(&ulArenaAllocations, __ATOMIC_RELAXED);
+    pxStats->ulFailures = __atomic_load_n(&ulArenaFailures, __ATOMIC_RELAXED);
+    pxStats->ulResets = ulArenaResets;
+    pxStats->ulAllocCyclesMax = __atomic_load_n(&ulArenaAllocCyclesMax, __ATOMIC_RELAXED);
+    pxStats->ulResetCyclesMax = __atomic_load_n(&ulArenaResetCyclesMax, __ATOMIC_RELAXED);
+}
+
+void vTimelineArenaClearStats(void) {
+    xArenaLastPeriodUsed = 0;
+    xArenaHighWater = 0;
+    ulArenaAllocations = 0;
+    ulArenaFailures = 0;
+    ulArenaResets = 0;
+    ulArenaAllocCyclesMax = 0;
+    ulArenaResetCyclesMax = 0;
+}
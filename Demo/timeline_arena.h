@@ -0,0 +1,138 @@
+/**
+ * @file timeline_arena.h
+ * @brief Frame arena: memory for timeline jobs, reclaimed wholesale.
+ *
+ * Jobs that need working memory take it from a static arena with a bump
+ * pointer instead of pvPortMalloc(). An allocation is one compare-and-swap on
+ * the arena offset, so its cost does not depend on what was allocated before,
+ * and memory is never freed individually: the scheduler rewinds the arena at
+ * every major-frame reset, before any job of the new frame is released, or at
+ * every sub-frame with TIMELINE_ARENA_PER_SUBFRAME. Nothing can fragment, and
+ * a job that is killed leaks nothing.
+ *
+ * Memory from the arena is only valid until the next rewind. Data that must
+ * outlive a frame belongs in a channel or in a state block. With
+ * TIMELINE_ARENA_PER_SUBFRAME, SRT jobs, which may run across sub-frames,
+ * must not keep arena memory across a sub-frame boundary.
+ *
+ * With the static task pool, the task control blocks and stacks of the jobs
+ * do not use the heap either, so nothing on the release path of a frame
+ * touches the general-purpose allocator.
+ */
+
+#ifndef TIMELINE_ARENA_H
+#define TIMELINE_ARENA_H
+
+#include "FreeRTOS.h"
+#include <stddef.h>
+
+// --- Public Configuration ---
+
+/**
+ * @brief Size of the arena, in bytes.
+ */
+#ifndef TIMELINE_ARENA_BYTES
+#define TIMELINE_ARENA_BYTES 2048
+#endif
+
+/**
+ * @brief Alignment of every allocation, in bytes. Must be a power of two.
+ */
+#ifndef TIMELINE_ARENA_ALIGNMENT
+#define TIMELINE_ARENA_ALIGNMENT portBYTE_ALIGNMENT
+#endif
+
+/**
+ * @brief Set to 1 to rewind the arena at every sub-frame instead of every major frame.
+ */
+#ifndef TIMELINE_ARENA_PER_SUBFRAME
+#define TIMELINE_ARENA_PER_SUBFRAME 0
+#endif
+
+/**
+ * @brief Set to 1 to report failed allocations to vApplicationTimelineArenaExhaustedHook().
+ */
+#ifndef TIMELINE_USE_ARENA_HOOK
+#define TIMELINE_USE_ARENA_HOOK 0
+#endif
+
+#if (TIMELINE_ARENA_ALIGNMENT & (TIMELINE_ARENA_ALIGNMENT - 1)) != 0
+#error "TIMELINE_ARENA_ALIGNMENT must be a power of two"
+#endif
+
+#if (TIMELINE_ARENA_BYTES % TIMELINE_ARENA_ALIGNMENT) != 0
+#error "TIMELINE_ARENA_BYTES must be a multiple of TIMELINE_ARENA_ALIGNMENT"
+#endif
+
+// --- Public Data Structures ---
+
+/**
+ * @brief Use and timing of the arena.
+ *
+ * A period is the time between two rewinds. The cycle counts are 0 without
+ * TIMELINE_ENABLE_STATS.
+ */
+typedef struct {
+    size_t xSize;               /**< TIMELINE_ARENA_BYTES. */
+    size_t xUsed;               /**< Bytes allocated in the current period, alignment included. */
+    size_t xLastPeriodUsed;     /**< Bytes allocated in the last complete period. */
+    size_t xHighWater;          /**< Most bytes allocated in any period, the current one included. */
+    uint32_t ulAllocations;     /**< Successful allocations. */
+    uint32_t ulFailures;        /**< Allocations refused because the arena was exhausted. */
+    uint32_t ulResets;          /**< Rewinds, one per period. */
+    uint32_t ulAllocCyclesMax;  /**< Longest allocation, failed ones included. */
+    uint32_t ulResetCyclesMax;  /**< Longest rewind. */
+} TimelineArenaStats_t;
+
+// --- Public API ---
+
+/**
+ * @brief Allocates memory from the arena.
+ *
+ * Never blocks and takes no lock, so it can be called from any job and from
+ * interrupts. The memory is aligned to TIMELINE_ARENA_ALIGNMENT and is not
+ * cleared.
+ *
+ * @param xSize Number of bytes.
+ * @return The memory, valid until the next rewind, or NULL if xSize is 0 or
+ * the arena does not have xSize bytes left.
+ */
+void *pvTimelineArenaAlloc(size_t xSize);
+
+/**
+ * @brief Returns the number of bytes left in the current period.
+ */
+size_t xTimelineArenaGetFree(void);
+
+/**
+ * @brief Rewinds the arena, releasing everything allocated from it. Called by the scheduler.
+ *
+ * Takes constant time: the contents are neither cleared nor walked.
+ */
+void vTimelineArenaReset(void);
+
+/**
+ * @brief Copies the use and timing statistics of the arena.
+ */
+void vTimelineArenaGetStats(TimelineArenaStats_t *pxStats);
+
+/**
+ * @brief Clears the statistics, keeping the current allocations. Called when a timeline starts.
+ */
+void vTimelineArenaClearStats(void);
+
+#if (TIMELINE_USE_ARENA_HOOK == 1)
+/**
+ * @brief Application hook called when an allocation does not fit in the arena.
+ *
+ * Provided by the application when TIMELINE_USE_ARENA_HOOK is set. Called in
+ * the context of the allocating job or interrupt, before pvTimelineArenaAlloc()
+ * returns NULL, so it must be short and must not block.
+ *
+ * @param xRequested Size of the refused allocation, in bytes.
+ * @param xFree Bytes left in the arena.
+ */
+void vApplicationTimelineArenaExhaustedHook(size_t xRequested, size_t xFree);
+#endif
+
+#endif // TIMELINE_ARENA_H
@@ -0,0 +1,123 @@
+/**
+ * @file timeline_channel.c
+ * @brief Implementation of the timeline polling channels.
+ *
+ * Each index is written by one side only. The data is written before the
+ * index that publishes it, with release ordering, and read after the index,
+ * with acquire ordering.
+ *
+ * A state buffer changes hands in two steps: the exchange of ucShared, then
+ * the update of the index the side keeps for itself. A job killed in between
+ * would lose a buffer, or leave two sides owning the same one, so both steps
+ * run with interrupts masked; the tick cannot come in, and neither can the
+ * kill. The mask is a BASEPRI write on the Cortex-M3, not a kernel call.
+ */
+
+#include "timeline_channel.h"
+
+// --- Private Definitions ---
+
+#define CHANNEL_INDEX_MASK 0x03U /**< Buffer index in ucShared. */
+#define CHANNEL_FRESH      0x04U /**< Set in ucShared when the buffer was published since the consumer last took one. */
+
+// --- State Channel Implementation ---
+
+void *pvTimelineChannelWriteBuffer(TimelineChannelState_t *pxChannel) {
+    return &pxChannel->pucBuffers[pxChannel->ucBack * pxChannel->xSize];
+}
+
+void vTimelineChannelPublish(TimelineChannelState_t *pxChannel) {
+    UBaseType_t uxSavedMask;
+    uint8_t ucPrevious;
+
+    pxChannel->ulFrames[pxChannel->ucBack] = ulTimelineSchedulerGetFrameCount();
+
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    ucPrevious = __atomic_exchange_n(&pxChannel->ucShared, (uint8_t)(pxChannel->ucBack | CHANNEL_FRESH),
+                                     __ATOMIC_ACQ_REL);
+    pxChannel->ucBack = ucPrevious & CHANNEL_INDEX_MASK;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+}
+
+const void *pvTimelineChannelRead(TimelineChannelState_t *pxChannel, BaseType_t *pxFresh) {
+    const void *pvState;
+    BaseType_t xFresh = pdFALSE;
+
+    if ((__atomic_load_n(&pxChannel->ucShared, __ATOMIC_ACQUIRE) & CHANNEL_FRESH) != 0) {
+        UBaseType_t uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        uint8_t ucPrevious = __atomic_exchange_n(&pxChannel->ucShared, pxChannel->ucFront, __ATOMIC_ACQ_REL);
+
+        pxChannel->ucFront = ucPrevious & CHANNEL_INDEX_MASK;
+        pxChannel->ucHasData = 1U;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+        xFresh = pdTRUE;
+    }
+
+    if (pxChannel->ucHasData == 0U ||
+        (pxChannel->xReset == TIMELINE_CHANNEL_PER_FRAME &&
+         pxChannel->ulFrames[pxChannel->ucFront] != ulTimelineSchedulerGetFrameCount())) {
+        // A buffer taken here but published in an earlier frame is not fresh state
+        pvState = NULL;
+        xFresh = pdFALSE;
+    } else {
+        pvState = &pxChannel->pucBuffers[pxChannel->ucFront * pxChannel->xSize];
+    }
+
+    if (pxFresh != NULL) {
+        *pxFresh = xFresh;
+    }
+    return pvState;
+}
+
+// --- Ring Channel Implementation ---
+
+void *pvTimelineRingClaim(TimelineRingChannel_t *pxChannel) {
+    uint32_t ulHead = pxChannel->ulHead;
+
+    if ((ulHead - __atomic_load_n(&pxChannel->ulTail, __ATOMIC_ACQUIRE)) > pxChannel->ulMask) {
+        pxChannel->ulDropped++;
+        return NULL;
+    }
+    return &pxChannel->pucSlots[(ulHead & pxChannel->ulMask) * pxChannel->xSize];
+}
+
+void vTimelineRingCommit(TimelineRingChannel_t *pxChannel) {
+    uint32_t ulHead = pxChannel->ulHead;
+
+    pxChannel->pulFrames[ulHead & pxChannel->ulMask] = ulTimelineSchedulerGetFrameCount();
+    __atomic_store_n(&pxChannel->ulHead, ulHead + 1, __ATOMIC_RELEASE);
+}
+
+const void *pvTimelineRingPeek(TimelineRingChannel_t *pxChannel) {
+    uint32_t ulTail = pxChannel->ulTail;
+    uint32_t ulHead = __atomic_load_n(&pxChannel->ulHead, __ATOMIC_ACQUIRE);
+
+    if (pxChannel->xReset == TIMELINE_CHANNEL_PER_FRAME) {
+        uint32_t ulFrame = ulTimelineSchedulerGetFrameCount();
+
+        // Messages are committed in frame order, so the stale ones are all at the front
+        while (ulTail != ulHead && pxChannel->pulFrames[ulTail & pxChannel->ulMask] != ulFrame) {
+            ulTail++;
+        }
+        if (ulTail != pxChannel->ulTail) {
+            __atomic_store_n(&pxChannel->ulTail, ulTail, __ATOMIC_RELEASE);
+        }
+    }
+
+    if (ulTail == ulHead) {
+        return NULL;
+    }
+    return &pxChannel->pucSlots[(ulTail & pxChannel->ulMask) * pxChannel->xSize];
+}
+
+void vTimelineRingConsume(TimelineRingChannel_t *pxChannel) {
+    uint32_t ulTail = pxChannel->ulTail;
+
+    if (ulTail != __atomic_load_n(&pxChannel->ulHead, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&pxChannel->ulTail, ulTail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+uint32_t ulTimelineRingGetDropped(const TimelineRingChannel_t *pxChannel) {
+    return __atomic_load_n(&pxChannel->ulDropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,191 @@
+/**
+ * @file timeline_channel.h
+ * @brief Polling channels between timeline jobs.
+ *
+ * Timeline tasks communicate only by polling. This module provides two
+ * single-producer, single-consumer channel types, both lock-free and
+ * wait-free, with no kernel calls:
+ *
+ * - A state channel holds the latest value of a piece of state. It is triple
+ *   buffered: the producer writes into a buffer it owns and publishes it with
+ *   one atomic exchange, and the consumer reads the latest published buffer
+ *   in place, so a value is never torn and neither side ever waits. Each
+ *   exchange runs with interrupts masked for a few instructions, so that a
+ *   kill cannot separate it from the bookkeeping of the buffer indices.
+ * - A ring channel is a FIFO of fixed-size messages. The producer claims a
+ *   slot, fills it in place and commits it; the consumer peeks at the oldest
+ *   message in place and then consumes it.
+ *
+ * A job killed in the middle of a write leaves nothing visible: an unpublished
+ * state buffer or an uncommitted ring slot belongs to the producer alone, and
+ * the next job of the producer simply writes it again. A consumer killed
+ * before it consumes a ring message sees the same message again in its next
+ * job.
+ *
+ * At the major-frame reset, a channel either keeps its contents or, with
+ * TIMELINE_CHANNEL_PER_FRAME, drops everything published in earlier frames.
+ * The drop is lazy: data is stamped with ulTimelineSchedulerGetFrameCount()
+ * when it is published and discarded by the consumer, so the scheduler never
+ * walks the channels.
+ *
+ * Channels are defined statically, next to the TimelineConfig_t table, with
+ * TIMELINE_CHANNEL_STATE_DEFINE() and TIMELINE_RING_CHANNEL_DEFINE(). Each
+ * channel must have one producer task and one consumer task.
+ */
+
+#ifndef TIMELINE_CHANNEL_H
+#define TIMELINE_CHANNEL_H
+
+#include "FreeRTOS.h"
+#include "timeline_scheduler.h"
+#include <stddef.h>
+
+// --- Public Data Structures ---
+
+/**
+ * @brief Behaviour of a channel at the major-frame reset.
+ */
+typedef enum {
+    TIMELINE_CHANNEL_KEEP = 0,   /**< Data survives the frame reset. */
+    TIMELINE_CHANNEL_PER_FRAME   /**< Data published in an earlier major frame is dropped. */
+} TimelineChannelReset_t;
+
+/**
+ * @brief A triple-buffered state channel. Define with TIMELINE_CHANNEL_STATE_DEFINE().
+ *
+ * At any time each of the three buffers is owned by the producer, by the
+ * consumer or by neither; ucShared holds the index of the last one along with
+ * a flag telling whether it was published since the consumer last took it.
+ */
+typedef struct {
+    uint8_t *pucBuffers;            /**< Three buffers of xSize bytes. */
+    size_t xSize;                   /**< Size of the state, in bytes. */
+    TimelineChannelReset_t xReset;
+    uint8_t ucShared;               /**< Buffer in between, plus the fresh flag; exchanged atomically. */
+    uint8_t ucBack;                 /**< Buffer owned by the producer. */
+    uint8_t ucFront;                /**< Buffer owned by the consumer. */
+    uint8_t ucHasData;              /**< Set once the consumer took a published buffer. */
+    uint32_t ulFrames[3];           /**< Frame count at which each buffer was published. */
+} TimelineChannelState_t;
+
+/**
+ * @brief A ring channel of fixed-size messages. Define with TIMELINE_RING_CHANNEL_DEFINE().
+ *
+ * The indices run freely and are reduced modulo the length, which is a
+ * power of two, when a slot is accessed.
+ */
+typedef struct {
+    uint8_t *pucSlots;              /**< ulMask + 1 slots of xSize bytes. */
+    uint32_t *pulFrames;            /**< Frame count at which the message of each slot was committed. */
+    size_t xSize;                   /**< Size of a message, in bytes. */
+    uint32_t ulMask;                /**< Number of slots minus one. */
+    TimelineChannelReset_t xReset;
+    uint32_t ulHead;                /**< Next slot to commit; written by the producer only. */
+    uint32_t ulTail;                /**< Oldest message; written by the consumer only. */
+    uint32_t ulDropped;             /**< Messages the producer could not queue because the ring was full. */
+} TimelineRingChannel_t;
+
+/**
+ * @brief Defines a state channel carrying values of type xType.
+ *
+ * @param xName Name of the TimelineChannelState_t variable.
+ * @param xType Type of the state.
+ * @param xResetMode One of TimelineChannelReset_t.
+ */
+#define TIMELINE_CHANNEL_STATE_DEFINE(xName, xType, xResetMode)                               \
+    static xType xName##Buffers[3];                                                           \
+    static TimelineChannelState_t xName = {                                                   \
+        .pucBuffers = (uint8_t *)xName##Buffers, .xSize = sizeof(xType), .xReset = (xResetMode), \
+        .ucShared = 1U, .ucBack = 0U, .ucFront = 2U, .ucHasData = 0U, .ulFrames = {0U, 0U, 0U} }
+
+/**
+ * @brief Defines a ring channel of uxLength messages of type xType.
+ *
+ * @param xName Name of the TimelineRingChannel_t variable.
+ * @param xType Type of a message.
+ * @param uxLength Number of slots; a power of two.
+ * @param xResetMode One of TimelineChannelReset_t.
+ */
+#define TIMELINE_RING_CHANNEL_DEFINE(xName, xType, uxLength, xResetMode)                      \
+    _Static_assert((uxLength) > 0 && ((uxLength) & ((uxLength) - 1)) == 0,                    \
+                   "the length of ring channel " #xName " must be a power of two");           \
+    static xType xName##Slots[(uxLength)];                                                    \
+    static uint32_t xName##Frames[(uxLength)];                                                \
+    static TimelineRingChannel_t xName = {                                                    \
+        .pucSlots = (uint8_t *)xName##Slots, .pulFrames = xName##Frames, .xSize = sizeof(xType), \
+        .ulMask = (uxLength) - 1U, .xReset = (xResetMode), .ulHead = 0U, .ulTail = 0U, .ulDropped = 0U }
+
+// --- State Channel API ---
+
+/**
+ * @brief Returns the buffer the producer writes the next state into.
+ *
+ * The buffer holds an older state, not necessarily the last one published:
+ * the producer must write the whole state before vTimelineChannelPublish().
+ * Producer side only.
+ */
+void *pvTimelineChannelWriteBuffer(TimelineChannelState_t *pxChannel);
+
+/**
+ * @brief Publishes the buffer returned by pvTimelineChannelWriteBuffer().
+ *
+ * Producer side only.
+ */
+void vTimelineChannelPublish(TimelineChannelState_t *pxChannel);
+
+/**
+ * @brief Returns the latest published state, read in place.
+ *
+ * The buffer stays valid and unchanged until the next call on this channel.
+ * Consumer side only.
+ *
+ * @param pxChannel The channel.
+ * @param pxFresh Receives pdTRUE if the state returned was published since
+ * the previous call, pdFALSE otherwise, and always pdFALSE along with NULL.
+ * May be NULL.
+ * @return The state, or NULL if nothing was published yet or, with
+ * TIMELINE_CHANNEL_PER_FRAME, nothing in the current major frame.
+ */
+const void *pvTimelineChannelRead(TimelineChannelState_t *pxChannel, BaseType_t *pxFresh);
+
+// --- Ring Channel API ---
+
+/**
+ * @brief Claims the slot of the next message, to be filled in place.
+ *
+ * Claiming again without a commit returns the same slot. Producer side only.
+ *
+ * @return The slot, or NULL if the ring is full; the message is then counted as dropped.
+ */
+void *pvTimelineRingClaim(TimelineRingChannel_t *pxChannel);
+
+/**
+ * @brief Makes the claimed slot visible to the consumer.
+ *
+ * Must follow a successful pvTimelineRingClaim(). Producer side only.
+ */
+void vTimelineRingCommit(TimelineRingChannel_t *pxChannel);
+
+/**
+ * @brief Returns the oldest message, read in place, without removing it.
+ *
+ * With TIMELINE_CHANNEL_PER_FRAME, messages committed in earlier major frames
+ * are removed first. Consumer side only.
+ *
+ * @return The message, or NULL if the ring is empty.
+ */
+const void *pvTimelineRingPeek(TimelineRingChannel_t *pxChannel);
+
+/**
+ * @brief Removes the message returned by pvTimelineRingPeek().
+ *
+ * Does nothing if the ring is empty. Consumer side only.
+ */
+void vTimelineRingConsume(TimelineRingChannel_t *pxChannel);
+
+/**
+ * @brief Returns the number of messages dropped because the ring was full.
+ */
+uint32_t ulTimelineRingGetDropped(const TimelineRingChannel_t *pxChannel);
+
+#endif // TIMELINE_CHANNEL_H
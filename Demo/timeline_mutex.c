@@ -0,0 +1,144 @@
+/**
+ * @file timeline_mutex.c
+ * @brief Implementation of the timeline mutex.
+ *
+ * The holder and the waiter list are only accessed in critical sections. A
+ * release wakes every waiter; each one retries and the first to run takes
+ * the mutex, while the others block again. Waiters stay registered until they
+ * take the mutex, time out or are reclaimed.
+ */
+
+#include "timeline_mutex.h"
+
+// --- Private Functions ---
+
+/**
+ * @brief Registers a task as waiting. Must be called in a critical section.
+ *
+ * @return pdTRUE if the task is registered, pdFALSE if the list is full.
+ */
+static BaseType_t prvAddWaiter(TimelineMutex_t *pxMutex, TaskHandle_t xTask) {
+    TaskHandle_t *pxFree = NULL;
+
+    for (UBaseType_t i = 0; i < TIMELINE_MUTEX_MAX_WAITERS; i++) {
+        if (pxMutex->xWaiters[i] == xTask) {
+            return pdTRUE;
+        }
+        if (pxMutex->xWaiters[i] == NULL && pxFree == NULL) {
+            pxFree = &pxMutex->xWaiters[i];
+        }
+    }
+
+    if (pxFree == NULL) {
+        return pdFALSE;
+    }
+    *pxFree = xTask;
+    return pdTRUE;
+}
+
+/**
+ * @brief Unregisters a waiting task, if registered. Must be called in a critical section.
+ */
+static void prvRemoveWaiter(TimelineMutex_t *pxMutex, TaskHandle_t xTask) {
+    for (UBaseType_t i = 0; i < TIMELINE_MUTEX_MAX_WAITERS; i++) {
+        if (pxMutex->xWaiters[i] == xTask) {
+            pxMutex->xWaiters[i] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Frees the mutex and wakes its waiters. Must be called in a critical section.
+ */
+static void prvUnlock(TimelineMutex_t *pxMutex) {
+    pxMutex->xHolder = NULL;
+    for (UBaseType_t i = 0; i < TIMELINE_MUTEX_MAX_WAITERS; i++) {
+        if (pxMutex->xWaiters[i] != NULL) {
+            xTaskNotifyGiveIndexed(pxMutex->xWaiters[i], TIMELINE_MUTEX_NOTIFY_INDEX);
+        }
+    }
+}
+
+/**
+ * @brief Releases a mutex on behalf of a job, see TimelineReleaseFunction_t.
+ *
+ * The job may hold the mutex, wait for it, or have released it already.
+ */
+static void prvMutexRelease(void *pvResource, TaskHandle_t xJob) {
+    TimelineMutex_t *pxMutex = (TimelineMutex_t *)pvResource;
+
+    taskENTER_CRITICAL();
+    prvRemoveWaiter(pxMutex, xJob);
+    if (pxMutex->xHolder == xJob) {
+        prvUnlock(pxMutex);
+    }
+    taskEXIT_CRITICAL();
+}
+
+// --- Public API Implementation ---
+
+void vTimelineMutexInit(TimelineMutex_t *pxMutex) {
+    pxMutex->xHolder = NULL;
+    for (UBaseType_t i = 0; i < TIMELINE_MUTEX_MAX_WAITERS; i++) {
+        pxMutex->xWaiters[i] = NULL;
+    }
+}
+
+BaseType_t xTimelineMutexTake(TimelineMutex_t *pxMutex, TickType_t xTicksToWait) {
+    TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+    BaseType_t xResult = pdFAIL;
+    TimeOut_t xTimeOut;
+
+    if (pxMutex->xHolder == xSelf) {
+        return pdFAIL;
+    }
+
+    // Tracked before waiting, so that a job killed in the wait leaves the waiter list too
+    if (xTimelineJobTrackResource(prvMutexRelease, pxMutex) != pdPASS) {
+        return pdFAIL;
+    }
+
+    vTaskSetTimeOutState(&xTimeOut);
+    for (;;) {
+        BaseType_t xWaiting = pdFALSE;
+
+        taskENTER_CRITICAL();
+        if (pxMutex->xHolder == NULL) {
+            pxMutex->xHolder = xSelf;
+            prvRemoveWaiter(pxMutex, xSelf);
+            xResult = pdPASS;
+        } else {
+            xWaiting = prvAddWaiter(pxMutex, xSelf);
+        }
+        taskEXIT_CRITICAL();
+
+        if (xResult == pdPASS || xWaiting == pdFALSE || xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE) {
+            break;
+        }
+        // Woken by a release, or by a stale notification from one that came after a timeout
+        (void)ulTaskNotifyTakeIndexed(TIMELINE_MUTEX_NOTIFY_INDEX, pdTRUE, xTicksToWait);
+    }
+
+    if (xResult != pdPASS) {
+        taskENTER_CRITICAL();
+        prvRemoveWaiter(pxMutex, xSelf);
+        taskEXIT_CRITICAL();
+        vTimelineJobUntrackResource(pxMutex);
+    }
+    return xResult;
+}
+
+BaseType_t xTimelineMutexGive(TimelineMutex_t *pxMutex) {
+    TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+
+    taskENTER_CRITICAL();
+    if (pxMutex->xHolder != xSelf) {
+        taskEXIT_CRITICAL();
+        return pdFAIL;
+    }
+    prvUnlock(pxMutex);
+    taskEXIT_CRITICAL();
+
+    vTimelineJobUntrackResource(pxMutex);
+    return pdPASS;
+}
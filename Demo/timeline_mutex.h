@@ -0,0 +1,81 @@
+/**
+ * @file timeline_mutex.h
+ * @brief Mutex that is released on behalf of a terminated timeline job.
+ *
+ * A job killed at its deadline never reaches the code that unlocks what it
+ * holds. Each take is tracked with xTimelineJobTrackResource(), so when the
+ * scheduler reclaims a killed job it frees the mutex and wakes the tasks
+ * waiting for it. A kernel mutex cannot be used for this: only its holder may
+ * give it back.
+ *
+ * The mutex is built on task notifications and critical sections only. It is
+ * not recursive and has no priority inheritance: under the timeline, HRT jobs
+ * never preempt each other, so a mutex shared between jobs is contended only
+ * by SRT jobs and by tasks outside the timeline.
+ */
+
+#ifndef TIMELINE_MUTEX_H
+#define TIMELINE_MUTEX_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timeline_scheduler.h"
+
+// --- Public Configuration ---
+
+/**
+ * @brief Maximum number of tasks that can wait for a timeline mutex at the same time.
+ */
+#ifndef TIMELINE_MUTEX_MAX_WAITERS
+#define TIMELINE_MUTEX_MAX_WAITERS 4
+#endif
+
+/**
+ * @brief Task notification index on which waiting tasks are woken.
+ */
+#define TIMELINE_MUTEX_NOTIFY_INDEX 3
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES <= TIMELINE_MUTEX_NOTIFY_INDEX)
+#error "configTASK_NOTIFICATION_ARRAY_ENTRIES is too small for TIMELINE_MUTEX_NOTIFY_INDEX"
+#endif
+
+// --- Public Data Structures ---
+
+/**
+ * @brief A timeline mutex. Initialise with vTimelineMutexInit() before use.
+ */
+typedef struct {
+    volatile TaskHandle_t xHolder;                   /**< Task holding the mutex, or NULL. */
+    TaskHandle_t xWaiters[TIMELINE_MUTEX_MAX_WAITERS]; /**< Tasks blocked in xTimelineMutexTake(); NULL slots are free. */
+} TimelineMutex_t;
+
+// --- Public API ---
+
+/**
+ * @brief Initialises a mutex in the released state.
+ */
+void vTimelineMutexInit(TimelineMutex_t *pxMutex);
+
+/**
+ * @brief Takes a mutex, waiting up to xTicksToWait for it to be released.
+ *
+ * When called from a managed job the mutex is tracked as a resource of the
+ * job, so it is released if the job is terminated while holding it or while
+ * waiting for it. Must not be called from an ISR.
+ *
+ * @param pxMutex The mutex.
+ * @param xTicksToWait Maximum time to wait; 0 to try once, portMAX_DELAY to wait forever.
+ * @return pdPASS if the mutex was taken, pdFAIL on timeout, if the caller
+ * already holds it, if TIMELINE_MUTEX_MAX_WAITERS tasks are already waiting,
+ * or if the job tracks TIMELINE_MAX_JOB_RESOURCES resources already.
+ */
+BaseType_t xTimelineMutexTake(TimelineMutex_t *pxMutex, TickType_t xTicksToWait);
+
+/**
+ * @brief Releases a mutex held by the calling task and wakes the tasks waiting for it.
+ *
+ * @return pdPASS, or pdFAIL if the caller does not hold the mutex.
+ */
+BaseType_t xTimelineMutexGive(TimelineMutex_t *pxMutex);
+
+#endif // TIMELINE_MUTEX_H
@@ -8,150 +8,2054 @@
 
 #include "timeline_scheduler.h"
 #include "trace.h"
+#include "timeline_stats.h"
+#include "timeline_timer.h"
+#include "timeline_state.h"
+#include "timeline_arena.h"
+#include "uart.h"
+#include <stdio.h>
 #include <string.h> // For memset
 
+// --- Private Definitions ---
+
+#if (TRACE_MAX_TASK_NAMES < MAX_TASKS)
+#error "TRACE_MAX_TASK_NAMES must be at least MAX_TASKS"
+#endif
+
+/**
+ * @brief Task notification index used by job wrappers to wake the scheduler.
+ *
+ * Index 0 is left free for application use of the plain notification API.
+ */
+#define TIMELINE_NOTIFY_INDEX 1
+
+#if (TIMELINE_TICK_DISPATCH == 1) && (TIMELINE_ABORT_NOTIFY_INDEX > 7)
+#error "TIMELINE_ABORT_NOTIFY_INDEX must be below 8: deferred notifications are kept as bits of a byte"
+#endif
+
+/**
+ * @brief Units of the event table offsets per microsecond, with the one-shot
+ * timer; see TIMELINE_UNITS_PER_TICK.
+ */
+#if (TIMELINE_ONESHOT_TIMER == 1)
+#define TIMELINE_UNITS_PER_US (TIMELINE_TIMER_HZ / 1000000UL)
+#endif
+
+/**
+ * @brief Length of a tick in microseconds, to place microsecond windows on the tick grid.
+ */
+#define TIMELINE_US_PER_TICK (1000000UL / configTICK_RATE_HZ)
+
 // --- Private Data Structures ---
 
 /**
- * @brief Internal state of a managed task.
+ * @brief A resource tracked by a job, see xTimelineJobTrackResource().
+ */
+typedef struct {
+    TimelineReleaseFunction_t pvRelease;
+    void *pvResource;
+} JobResource_t;
+
+/**
+ * @brief Internal state of a managed task.
+ *
+ * One is reserved per MAX_TASKS slot, so the flags are single bytes: each is
+ * written whole by one context at a time, which a byte store does atomically,
+ * whereas bit-fields would need read-modify-write cycles shared across the
+ * dispatcher interrupt and the jobs.
+ */
+typedef struct {
+    const TimelineTaskConfig_t *pxConfig; /**< Pointer to the public task configuration. */
+    TaskHandle_t xHandle;                 /**< Handle of the FreeRTOS task. */
+    uint32_t ulStackDepth;                /**< Resolved stack depth of the task, in words. */
+    uint32_t ulDeadline;                  /**< End of the HRT window of the first instance, in event table units. */
+    TaskFunction_t pvJobCode;             /**< Function of the current job: the task's own or its degraded handler. */
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    StackType_t *pxStack;                 /**< Stack of the pooled task, carved from the stack arena. */
+#endif
+    uint32_t ulSkipRemaining;             /**< Releases still to skip under TIMELINE_MISS_SKIP. */
+    TimelineTaskCounters_t xCounters;     /**< Miss and overrun counters, see xTimelineSchedulerGetTaskCounters(). */
+    TickType_t xAbortTick;                /**< Tick of the abort request, for the trace. */
+    JobResource_t xResources[TIMELINE_MAX_JOB_RESOURCES]; /**< Resources held by the current job, in tracking order. */
+    volatile uint8_t ucResourceCount;
+    uint8_t ucIsActive;                   /**< Flag to indicate if the task is currently running. */
+    volatile uint8_t ucCompleted;         /**< Set by the job wrapper when the task function returns. */
+#if (TIMELINE_TICK_DISPATCH == 1)
+    volatile uint8_t ucKillPending;       /**< Killed by the dispatcher; the reaper has not recreated the task yet. */
+    uint8_t ucNotifyPending;              /**< Notification indices, as bits, deferred by the dispatcher in task context. */
+    uint8_t ucNotifyQueued;               /**< Set while the job is in usNotifyQueue. */
+#endif
+    uint8_t ucDegraded;                   /**< Set under TIMELINE_MISS_DEGRADE after a miss, until a job completes. */
+    volatile uint8_t ucAbortRequested;    /**< Set when the current job was asked to stop, until the next release. */
+    uint8_t ucInstance;                   /**< Instance of a multi-rate task released last, 0 otherwise. */
+} ManagedTask_t;
+
+/**
+ * @brief Value of uxPendingSchedule when no switch has been requested.
+ */
+#define TIMELINE_NO_PENDING_SWITCH ((UBaseType_t)-1)
+
+/**
+ * @brief Storage of an event table and SRT order compiled at registration.
+ */
+typedef struct {
+    TimelineEvent_t xEvents[TIMELINE_MAX_EVENTS];
+    uint16_t usSoftTaskOrder[MAX_TASKS];
+} TimelineTableStorage_t;
+
+/**
+ * @brief A registered schedule, bound to its event table and SRT order.
+ *
+ * The table lives in flash for schedules declared with TIMELINE_DEFINE(), and
+ * in a TimelineTableStorage_t otherwise.
+ */
+typedef struct {
+    TimelineConfig_t xConfig;                     /**< Copy of the public configuration. */
+    uint32_t ulMajorFrameTicks;                   /**< Resolved length of the major frame. */
+    uint32_t ulSubframeTicks;                     /**< Resolved length of a sub-frame. */
+    const TimelineEvent_t *pxEvents;              /**< Release, deadline, abort and sub-frame events, sorted by time. */
+    UBaseType_t uxEventCount;
+    const uint16_t *pusSoftTaskOrder;             /**< Managed task indices of the SRT tasks, in declaration order. */
+    UBaseType_t uxSoftTaskCount;
+} TimelineSchedule_t;
+
+// --- Private State ---
+
+static TimelineSchedule_t xSchedules[TIMELINE_MAX_SCHEDULES];
+static UBaseType_t uxScheduleCount = 0;
+
+#if (TIMELINE_MAX_COMPILED_SCHEDULES > 0)
+static TimelineTableStorage_t xTableStorage[TIMELINE_MAX_COMPILED_SCHEDULES];
+#endif
+static UBaseType_t uxTableStorageCount = 0; /**< Entries of xTableStorage used by registered schedules. */
+static const TimelineSchedule_t *pxActiveSchedule = NULL;
+
+static volatile UBaseType_t uxPendingSchedule = TIMELINE_NO_PENDING_SWITCH; /**< Schedule to switch to at the next frame boundary. */
+static volatile TickType_t xSwitchRequestTick = 0;                          /**< Tick at which the pending switch was requested. */
+
+static ManagedTask_t xManagedTasks[MAX_TASKS];
+static UBaseType_t uxManagedTasksCount = 0;
+static TaskHandle_t xSchedulerTaskHandle = NULL;
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+static StaticTask_t xJobTaskBuffers[MAX_TASKS];
+static StackType_t xJobStackArena[TIMELINE_STACK_ARENA_WORDS];
+#endif
+
+static ManagedTask_t *pxActiveJob = NULL; /**< HRT job currently owning the CPU, if any. */
+
+static UBaseType_t uxNextSoftTask = 0;      /**< Position in the active SRT order of the next SRT job to start. */
+static ManagedTask_t *pxActiveSoftJob = NULL; /**< SRT job started in the current frame and not yet finished. */
+
+static TickType_t xFrameEpoch = 0;        /**< Absolute tick at which the current major frame started. */
+static uint32_t ulFrameOverrunCount = 0;  /**< Number of major frames that started late. */
+static volatile uint32_t ulFrameCount = 0; /**< Number of major frames started. */
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_DUMP_PERIOD_FRAMES > 0)
+static uint32_t ulFramesSinceDump = 0;    /**< Frames elapsed since the last statistics dump. */
+#endif
+
+#if (TIMELINE_TICK_DISPATCH == 1)
+/* Dispatcher state. Written in the tick interrupt, and by tasks only with
+ * interrupts masked. xSchedulerTaskHandle is the reaper task in this mode. */
+static volatile BaseType_t xDispatchRunning = pdFALSE;  /**< Set once the reaper has started the first frame. */
+#if (TIMELINE_ONESHOT_TIMER == 0)
+static volatile TickType_t xDispatchTick = 0;           /**< Ticks seen by the tick hook; unlike xTickCount it never lags while the scheduler is suspended. */
+#endif
+static uint32_t ulDispatchEpoch = 0;                    /**< Start of the current frame in event table units; xFrameEpoch is the same instant in ticks. */
+static BaseType_t xDispatchWoken = pdFALSE;             /**< Set when a notification from the dispatcher woke a higher priority task. */
+static UBaseType_t uxNextEvent = 0;                     /**< Next entry of the active event table. */
+static volatile BaseType_t xBoundaryPending = pdFALSE;  /**< Frame boundary held for the reaper to apply a schedule switch. */
+static volatile BaseType_t xDumpPending = pdFALSE;      /**< Statistics dump requested from the reaper. */
+static uint16_t usKillQueue[MAX_TASKS + 1];             /**< Jobs killed and not yet reaped, oldest first; a job is queued once at most. */
+static volatile UBaseType_t uxKillHead = 0;             /**< Entry of usKillQueue the reaper takes next. */
+static volatile UBaseType_t uxKillTail = 0;             /**< Entry of usKillQueue the next kill is written to. */
+static BaseType_t xDispatchInISR = pdFALSE;             /**< Set while the dispatcher runs in the tick or timer interrupt. */
+static uint16_t usNotifyQueue[MAX_TASKS];               /**< Jobs with notifications deferred by the dispatcher in task context; a job is queued once at most. */
+static UBaseType_t uxNotifyCount = 0;                   /**< Entries of usNotifyQueue. */
+static BaseType_t xNotifyReaper = pdFALSE;              /**< Notification of the reaper deferred by the dispatcher in task context. */
+#endif
+
+// --- Private Functions ---
+
+/**
+ * @brief Returns the index of a managed task in the configuration.
+ *
+ * The index doubles as the task id in trace records and statistics.
+ */
+static uint16_t prvTaskIndex(const ManagedTask_t *pxTask) {
+    return (uint16_t)(pxTask - xManagedTasks);
+}
+
+/**
+ * @brief Logs an event of the current job of a task, with its instance.
+ */
+static void prvTraceJob(TraceEvent_t xEvent, const ManagedTask_t *pxTask, TickType_t xTick, uint32_t ulArg) {
+    vTraceLogInstance(xEvent, prvTaskIndex(pxTask), pxTask->ucInstance, xTick, ulArg);
+}
+
+/**
+ * @brief Returns the FreeRTOS priority at which a managed job runs.
+ *
+ * SRT jobs run below HRT jobs, so an HRT release preempts the running SRT job
+ * immediately and the SRT job resumes where it stopped once the CPU is free
+ * again.
+ */
+static UBaseType_t prvJobPriority(const ManagedTask_t *pxTask) {
+    return (pxTask->pxConfig->xTaskType == TASK_TYPE_HARD_RT) ? TIMELINE_HRT_PRIORITY : TIMELINE_SRT_PRIORITY;
+}
+
+/**
+ * @brief Returns the stack depth, in words, of a configured task.
+ */
+static uint32_t prvStackDepth(const TimelineTaskConfig_t *pxConfig) {
+    uint32_t ulDepth = (pxConfig->ulStackDepth != 0) ? pxConfig->ulStackDepth : TIMELINE_TASK_STACK_DEPTH;
+
+    return (ulDepth < configMINIMAL_STACK_SIZE) ? configMINIMAL_STACK_SIZE : ulDepth;
+}
+
+/**
+ * @brief Returns the utilisation category under which a job's CPU time is accounted.
+ */
+static TimelineUtilCategory_t prvJobCategory(const ManagedTask_t *pxTask) {
+    return (pxTask->pxConfig->xTaskType == TASK_TYPE_HARD_RT) ? TIMELINE_UTIL_HRT : TIMELINE_UTIL_SRT;
+}
+
+/**
+ * @brief Selects the function run by the next job of a task.
+ *
+ * @return pdTRUE if the job runs the degraded handler of TIMELINE_MISS_DEGRADE.
+ */
+static BaseType_t prvSelectJobCode(ManagedTask_t *pxTask) {
+    if (pxTask->ucDegraded != pdFALSE) {
+        pxTask->pvJobCode = pxTask->pxConfig->pvDegradedCode;
+        pxTask->xCounters.ulDegradedRuns++;
+        return pdTRUE;
+    }
+    pxTask->pvJobCode = pxTask->pxConfig->pvTaskCode;
+    return pdFALSE;
+}
+
+/**
+ * @brief Decides whether a due HRT release may start.
+ *
+ * A release is skipped while the miss policy holds the task back, when an
+ * earlier job still owns the CPU (HRT jobs are non-preemptive), or when the
+ * scheduler reaches it only after its window has closed. Every skip is traced
+ * with its reason; the last two are counted as overruns.
+ *
+ * @param pxTask The released task.
+ * @param xBusy pdTRUE if another HRT job owns the CPU.
+ * @param ulIntoFrame Current time from the start of the frame, in event table units.
+ * @param xNow Current tick, for the trace.
+ * @return pdTRUE if the job may start.
+ */
+static BaseType_t prvAdmitRelease(ManagedTask_t *pxTask, BaseType_t xBusy, uint32_t ulIntoFrame, TickType_t xNow) {
+    const uint32_t ulDeadline = pxTask->ulDeadline +
+                                pxTask->ucInstance * pxTask->pxConfig->ulPeriodTicks * TIMELINE_UNITS_PER_TICK;
+    uint32_t ulReason;
+
+    if (pxTask->ulSkipRemaining != 0) {
+        pxTask->ulSkipRemaining--;
+        pxTask->xCounters.ulPolicySkips++;
+        ulReason = TRACE_SKIP_POLICY;
+    } else if (xBusy != pdFALSE) {
+        pxTask->xCounters.ulOverruns++;
+        ulReason = TRACE_SKIP_BUSY;
+    } else if (ulIntoFrame >= ulDeadline) {
+        pxTask->xCounters.ulOverruns++;
+        ulReason = TRACE_SKIP_LATE;
+    } else {
+        return pdTRUE;
+    }
+
+    prvTraceJob(TRACE_EVENT_RELEASE_SKIPPED, pxTask, xNow, ulReason);
+    return pdFALSE;
+}
+
+/**
+ * @brief Counts a deadline miss and applies the miss policy of the task.
+ *
+ * Called once the job has been terminated and the miss traced, from the
+ * scheduler task or from the dispatcher interrupt.
+ */
+static void prvApplyMissPolicy(ManagedTask_t *pxTask) {
+    const TimelineTaskConfig_t *pxConfig = pxTask->pxConfig;
+
+    pxTask->xCounters.ulMisses++;
+
+    switch (pxConfig->xMissPolicy) {
+        case TIMELINE_MISS_SKIP:
+            pxTask->ulSkipRemaining = (pxConfig->ulMissSkipReleases != 0) ? pxConfig->ulMissSkipReleases : 1;
+            break;
+        case TIMELINE_MISS_DEGRADE:
+            pxTask->ucDegraded = pdTRUE;
+            break;
+        case TIMELINE_MISS_ESCALATE:
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+            vApplicationTimelineDeadlineHook(prvTaskIndex(pxTask), pxConfig->pcName);
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Asks a running HRT job to stop ahead of its deadline.
+ *
+ * The caller gives the notification at TIMELINE_ABORT_NOTIFY_INDEX, from
+ * task or interrupt context.
+ *
+ * @param xNow Current tick.
+ * @return pdTRUE if the request was made, pdFALSE if the job is not running
+ * or was asked already.
+ */
+static BaseType_t prvRequestAbort(ManagedTask_t *pxTask, TickType_t xNow) {
+    if (pxTask->ucIsActive == pdFALSE || pxTask->ucCompleted != pdFALSE || pxTask->ucAbortRequested != pdFALSE) {
+        return pdFALSE;
+    }
+
+    pxTask->xAbortTick = xNow;
+    pxTask->ucAbortRequested = pdTRUE;
+    prvTraceJob(TRACE_EVENT_ABORT_REQUEST, pxTask, xNow, 0);
+    return pdTRUE;
+}
+
+/**
+ * @brief Traces a job that returned, and ends its degraded runs if it completed.
+ *
+ * A job that returns after an abort request gave up on its work, so it is
+ * not the successful run that lifts TIMELINE_MISS_DEGRADE.
+ *
+ * @param xNow Current tick.
+ */
+static void prvJobReturned(ManagedTask_t *pxTask, TickType_t xNow) {
+    if (pxTask->ucAbortRequested != pdFALSE) {
+        prvTraceJob(TRACE_EVENT_JOB_ABORTED, pxTask, xNow, xNow - pxTask->xAbortTick);
+    } else {
+        pxTask->ucDegraded = pdFALSE;
+        prvTraceJob(TRACE_EVENT_TASK_COMPLETE, pxTask, xNow, 0);
+    }
+}
+
+/**
+ * @brief Returns the managed task whose job runs in a given task, or NULL.
+ */
+static ManagedTask_t *prvFindJob(TaskHandle_t xTask) {
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    // The handle of a pooled task is the address of its TCB buffer, which gives its slot
+    uintptr_t uxOffset = (uintptr_t)xTask - (uintptr_t)xJobTaskBuffers;
+
+    if (xTask != NULL && uxOffset < sizeof(xJobTaskBuffers) && (uxOffset % sizeof(StaticTask_t)) == 0) {
+        ManagedTask_t *pxTask = &xManagedTasks[uxOffset / sizeof(StaticTask_t)];
+
+        if (pxTask->xHandle == xTask) {
+            return pxTask;
+        }
+    }
+#else
+    // Tasks come from the heap in this mode, so only a search can tell
+    for (UBaseType_t i = 0; i < uxManagedTasksCount && xTask != NULL; i++) {
+        if (xManagedTasks[i].xHandle == xTask) {
+            return &xManagedTasks[i];
+        }
+    }
+#endif
+    return NULL;
+}
+
+/**
+ * @brief Returns the managed task whose job is the calling task, or NULL.
+ */
+static ManagedTask_t *prvCurrentJob(void) {
+    return prvFindJob(xTaskGetCurrentTaskHandle());
+}
+
+/**
+ * @brief Releases the resources still tracked by a job, most recent first.
+ *
+ * Called by the job wrapper when the job returns, and by the scheduler or
+ * the reaper once the task of a terminated job has been deleted, before the
+ * slot can run its next job.
+ *
+ * @param xJob Handle of the job's task, passed on to the release functions.
+ */
+static void prvReleaseResources(ManagedTask_t *pxTask, TaskHandle_t xJob) {
+    while (pxTask->ucResourceCount != 0) {
+        const JobResource_t *pxResource = &pxTask->xResources[pxTask->ucResourceCount - 1];
+
+        // Dropped only once released: a job killed in between sees the release repeated, never skipped
+        pxResource->pvRelease(pxResource->pvResource, xJob);
+        pxTask->ucResourceCount--;
+    }
+}
+
+#if (TIMELINE_TICK_DISPATCH == 1)
+static void prvTickJobCompleted(ManagedTask_t *pxTask);
+static void prvFlushNotifications(void);
+#endif
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+
+/**
+ * @brief Entry point of every pooled job task.
+ *
+ * The task is created once and then waits for a release notification. Each
+ * release runs the configured task function from start to end and signals
+ * the scheduler, after which the task goes back to waiting.
+ *
+ * @param pvParameters Pointer to the ManagedTask_t describing this job.
+ */
+static void prvJobWrapper(void *pvParameters) {
+    ManagedTask_t *pxTask = (ManagedTask_t *)pvParameters;
+
+    for (;;) {
+        (void)ulTaskNotifyTakeIndexed(TIMELINE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+        // An abort request the previous job returned without taking must not
+        // wake this one; a request already made for this job is kept
+        taskENTER_CRITICAL();
+        if (pxTask->ucAbortRequested == pdFALSE) {
+            (void)ulTaskNotifyTakeIndexed(TIMELINE_ABORT_NOTIFY_INDEX, pdTRUE, 0);
+        }
+        taskEXIT_CRITICAL();
+
+        vTimelineStatsJobStart(prvTaskIndex(pxTask));
+        pxTask->pvJobCode(NULL);
+        prvReleaseResources(pxTask, pxTask->xHandle);
+
+#if (TIMELINE_TICK_DISPATCH == 1)
+        // The reaper only samples the stack of killed jobs; completions are sampled
+        // here, in the job's own task, before it goes back to waiting
+        vTimelineStatsStackCheck(prvTaskIndex(pxTask), pxTask->xHandle, pxTask->ulStackDepth);
+
+        // No scheduler task to notify: the completion is booked here, atomically
+        // with respect to a deadline kill in the tick interrupt
+        taskENTER_CRITICAL();
+        if (pxTask->ucIsActive != pdFALSE) {
+            vTimelineStatsJobEnd(prvTaskIndex(pxTask), pdFALSE);
+            prvTickJobCompleted(pxTask);
+        }
+        taskEXIT_CRITICAL();
+        prvFlushNotifications();
+#else
+        vTimelineStatsJobEnd(prvTaskIndex(pxTask), pdFALSE);
+
+        pxTask->ucCompleted = pdTRUE;
+        xTaskNotifyGiveIndexed(xSchedulerTaskHandle, TIMELINE_NOTIFY_INDEX);
+#endif
+    }
+}
+
+/**
+ * @brief Creates the pooled task of a managed job in its static buffers.
+ *
+ * Called once per task when its schedule is activated, and again after a kill
+ * to bring the job back in its initial state. No heap memory is involved.
+ *
+ * @return pdPASS if the task was created, pdFAIL otherwise.
+ */
+static BaseType_t prvCreateJobTask(ManagedTask_t *pxTask) {
+    UBaseType_t uxSlot = (UBaseType_t)(pxTask - xManagedTasks);
+
+    pxTask->xHandle = xTaskCreateStatic(prvJobWrapper,
+                                        pxTask->pxConfig->pcName,
+                                        pxTask->ulStackDepth,
+                                        pxTask,
+                                        prvJobPriority(pxTask),
+                                        pxTask->pxStack,
+                                        &xJobTaskBuffers[uxSlot]);
+
+    if (pxTask->xHandle != NULL) {
+        vTimelineStatsTagTask(pxTask->xHandle, prvJobCategory(pxTask));
+    }
+
+    return (pxTask->xHandle != NULL) ? pdPASS : pdFAIL;
+}
+
+#else
+
+/**
+ * @brief Entry point of every managed job.
+ *
+ * Runs the configured task function from start to end and then signals the
+ * scheduler. The scheduler runs at a higher priority, so it preempts the job
+ * inside the notification call and reclaims the task; the job never has to
+ * delete itself.
+ *
+ * @param pvParameters Pointer to the ManagedTask_t describing this job.
+ */
+static void prvJobWrapper(void *pvParameters) {
+    ManagedTask_t *pxTask = (ManagedTask_t *)pvParameters;
+
+    vTimelineStatsJobStart(prvTaskIndex(pxTask));
+    pxTask->pvJobCode(NULL);
+    prvReleaseResources(pxTask, pxTask->xHandle);
+    vTimelineStatsJobEnd(prvTaskIndex(pxTask), pdFALSE);
+
+    pxTask->ucCompleted = pdTRUE;
+    xTaskNotifyGiveIndexed(xSchedulerTaskHandle, TIMELINE_NOTIFY_INDEX);
+
+    // Only reached if the scheduler has not reclaimed the task yet.
+    for (;;) {
+        vTaskSuspend(NULL);
+    }
+}
+
+#endif /* TIMELINE_USE_STATIC_TASK_POOL */
+
+#if (TIMELINE_TICK_DISPATCH == 0)
+
+/**
+ * @brief Returns the task of a finished or terminated job to its idle state.
+ *
+ * Without the static pool the task is simply deleted. With the pool, a job
+ * that completed is already waiting for its next release, while a killed job
+ * is deleted and recreated in place so that it restarts from a clean state.
+ * The resources a killed job still tracked are then released on its behalf,
+ * and the time from the kill to this point is traced.
+ *
+ * @param pxTask The job to reclaim.
+ * @param xKilled pdTRUE if the job was terminated before completing.
+ */
+static void prvReclaimJob(ManagedTask_t *pxTask, BaseType_t xKilled) {
+    TaskHandle_t xJob = pxTask->xHandle;
+
+    vTimelineStatsStackCheck(prvTaskIndex(pxTask), xJob, pxTask->ulStackDepth);
+    if (xKilled != pdFALSE) {
+        vTimelineStatsJobEnd(prvTaskIndex(pxTask), pdTRUE);
+    }
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    if (xKilled != pdFALSE) {
+        vTaskDelete(xJob);
+        // Cannot fail: the static buffers of this slot were just released
+        (void)prvCreateJobTask(pxTask);
+    }
+#else
+    vTaskDelete(xJob);
+    pxTask->xHandle = NULL;
+#endif
+    pxTask->ucIsActive = pdFALSE;
+
+    if (xKilled != pdFALSE) {
+        prvReleaseResources(pxTask, xJob);
+        prvTraceJob(TRACE_EVENT_JOB_RECLAIMED, pxTask, xTaskGetTickCount(),
+                    ulTimelineStatsJobReclaimed(prvTaskIndex(pxTask)));
+    }
+}
+
+#endif /* TIMELINE_TICK_DISPATCH */
+
+/**
+ * @brief Deletes the tasks of all managed jobs, whatever their state.
+ */
+static void prvDeleteJobTasks(void) {
+    for (UBaseType_t i = 0; i < uxManagedTasksCount; i++) {
+        TaskHandle_t xJob = xManagedTasks[i].xHandle;
+
+        if (xJob != NULL) {
+            vTaskDelete(xJob);
+            xManagedTasks[i].xHandle = NULL;
+            prvReleaseResources(&xManagedTasks[i], xJob);
+        }
+        xManagedTasks[i].ucIsActive = pdFALSE;
+    }
+}
+
+/**
+ * @brief Orders two events by offset, then kind, then index.
+ *
+ * @return A negative, zero or positive value, in the manner of strcmp().
+ */
+static BaseType_t prvCompareEvents(const TimelineEvent_t *pxA, const TimelineEvent_t *pxB) {
+    if (pxA->ulOffset != pxB->ulOffset) {
+        return (pxA->ulOffset < pxB->ulOffset) ? -1 : 1;
+    }
+    if (pxA->ucKind != pxB->ucKind) {
+        return (BaseType_t)pxA->ucKind - (BaseType_t)pxB->ucKind;
+    }
+    return (BaseType_t)pxA->usIndex - (BaseType_t)pxB->usIndex;
+}
+
+/**
+ * @brief Appends an event to a schedule's table, keeping it sorted.
+ *
+ * Insertion sort is used as the table is small and built only once, when the
+ * schedule is registered.
+ *
+ * @param pxEvents The table storage of the schedule.
+ * @param uxInstance Instance of a multi-rate task, 0 otherwise.
+ * @return pdPASS, or pdFAIL if the table already holds TIMELINE_MAX_EVENTS entries.
+ */
+static BaseType_t prvInsertEvent(TimelineSchedule_t *pxSchedule, TimelineEvent_t *pxEvents, uint32_t ulOffset,
+                                 TimelineEventKind_t xKind, UBaseType_t uxIndex, UBaseType_t uxInstance) {
+    TimelineEvent_t xEvent;
+    UBaseType_t uxPos = pxSchedule->uxEventCount;
+
+    if (uxPos >= TIMELINE_MAX_EVENTS) {
+        return pdFAIL;
+    }
+
+    xEvent.ulOffset = ulOffset;
+    xEvent.usIndex = (uint16_t)uxIndex;
+    xEvent.ucKind = (uint8_t)xKind;
+    xEvent.ucInstance = (uint8_t)uxInstance;
+
+    while ((uxPos > 0) && (prvCompareEvents(&pxEvents[uxPos - 1], &xEvent) > 0)) {
+        pxEvents[uxPos] = pxEvents[uxPos - 1];
+        uxPos--;
+    }
+    pxEvents[uxPos] = xEvent;
+    pxSchedule->uxEventCount++;
+    return pdPASS;
+}
+
+/**
+ * @brief Converts the window of an HRT task to event table units.
+ *
+ * @return pdPASS, or pdFAIL if a microsecond window does not fall on tick
+ * edges and there is no one-shot timer to keep its precision.
+ */
+static BaseType_t prvWindowUnits(const TimelineTaskConfig_t *pxConfig, uint32_t *pulStart, uint32_t *pulEnd) {
+    if (pxConfig->ulEndTimeUs == 0) {
+        *pulStart = pxConfig->ulStartTimeTicks * TIMELINE_UNITS_PER_TICK;
+        *pulEnd = pxConfig->ulEndTimeTicks * TIMELINE_UNITS_PER_TICK;
+        return pdPASS;
+    }
+
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    *pulStart = pxConfig->ulStartTimeUs * TIMELINE_UNITS_PER_US;
+    *pulEnd = pxConfig->ulEndTimeUs * TIMELINE_UNITS_PER_US;
+#else
+    if ((pxConfig->ulStartTimeUs % TIMELINE_US_PER_TICK) != 0 || (pxConfig->ulEndTimeUs % TIMELINE_US_PER_TICK) != 0) {
+        return pdFAIL;
+    }
+    *pulStart = pxConfig->ulStartTimeUs / TIMELINE_US_PER_TICK;
+    *pulEnd = pxConfig->ulEndTimeUs / TIMELINE_US_PER_TICK;
+#endif
+    return pdPASS;
+}
+
+/**
+ * @brief Checks that the miss policy of an HRT task is known and has what it needs.
+ */
+static BaseType_t prvValidateMissPolicy(const TimelineTaskConfig_t *pxConfig) {
+    switch (pxConfig->xMissPolicy) {
+        case TIMELINE_MISS_KILL:
+        case TIMELINE_MISS_SKIP:
+            return pdPASS;
+        case TIMELINE_MISS_DEGRADE:
+            return (pxConfig->pvDegradedCode != NULL) ? pdPASS : pdFAIL;
+        case TIMELINE_MISS_ESCALATE:
+            return (TIMELINE_USE_DEADLINE_HOOK == 1) ? pdPASS : pdFAIL;
+        default:
+            return pdFAIL;
+    }
+}
+
+/**
+ * @brief Checks that an HRT window, in event table units, fits in the major
+ * frame and in its sub-frame.
+ *
+ * The window of a multi-rate task is one of its instances, which belongs to
+ * the sub-frame it starts in.
+ */
+static BaseType_t prvValidateHardTask(const TimelineSchedule_t *pxSchedule, const TimelineTaskConfig_t *pxConfig,
+                                      uint32_t ulStart, uint32_t ulEnd) {
+    const uint32_t ulSubframeUnits = pxSchedule->ulSubframeTicks * TIMELINE_UNITS_PER_TICK;
+    uint32_t ulSubframeStart = pxConfig->ulSubframeId * ulSubframeUnits;
+
+    if (pxConfig->ulPeriodTicks != 0) {
+        ulSubframeStart = (ulStart / ulSubframeUnits) * ulSubframeUnits;
+    } else if (pxConfig->ulSubframeId >= (pxSchedule->ulMajorFrameTicks / pxSchedule->ulSubframeTicks)) {
+        return pdFAIL;
+    }
+
+    if (ulStart >= ulEnd ||
+        ulEnd > pxSchedule->ulMajorFrameTicks * TIMELINE_UNITS_PER_TICK ||
+        ulStart < ulSubframeStart ||
+        ulEnd > ulSubframeStart + ulSubframeUnits) {
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+/**
+ * @brief Returns the number of releases of an HRT task per major frame, or 0
+ * if its period is invalid.
+ *
+ * @param ulEnd End of the window of the first instance, in event table units.
+ */
+static UBaseType_t prvInstanceCount(const TimelineSchedule_t *pxSchedule, const TimelineTaskConfig_t *pxConfig,
+                                    uint32_t ulEnd) {
+    const uint32_t ulPeriod = pxConfig->ulPeriodTicks;
+
+    if (ulPeriod == 0) {
+        return 1;
+    }
+    // Instances must not overlap: each one ends before the next is released
+    if ((pxSchedule->ulMajorFrameTicks % ulPeriod) != 0 ||
+        (pxSchedule->ulMajorFrameTicks / ulPeriod) > UINT8_MAX ||
+        ulEnd > ulPeriod * TIMELINE_UNITS_PER_TICK) {
+        return 0;
+    }
+    return (UBaseType_t)(pxSchedule->ulMajorFrameTicks / ulPeriod);
+}
+
+/**
+ * @brief Builds the sorted event table and SRT order of a configuration
+ * without a precompiled table, in the next free table storage.
+ *
+ * @return pdPASS on success, pdFAIL if a task is invalid, the table exceeds
+ * TIMELINE_MAX_EVENTS or no storage is left.
+ */
+static BaseType_t prvBuildTable(TimelineSchedule_t *pxSchedule, const TimelineConfig_t *pxConfig) {
+#if (TIMELINE_MAX_COMPILED_SCHEDULES > 0)
+    TimelineTableStorage_t *pxStorage;
+
+    if (uxTableStorageCount >= TIMELINE_MAX_COMPILED_SCHEDULES) {
+        return pdFAIL;
+    }
+    pxStorage = &xTableStorage[uxTableStorageCount];
+
+    pxSchedule->uxEventCount = 0;
+    for (UBaseType_t i = 0; i < pxSchedule->ulMajorFrameTicks / pxSchedule->ulSubframeTicks; i++) {
+        if (prvInsertEvent(pxSchedule, pxStorage->xEvents, i * pxSchedule->ulSubframeTicks * TIMELINE_UNITS_PER_TICK,
+                           TIMELINE_EVENT_SUBFRAME, i, 0) != pdPASS) {
+            return pdFAIL;
+        }
+    }
+
+    // SRT jobs run in the order in which they are declared
+    pxSchedule->uxSoftTaskCount = 0;
+    for (UBaseType_t i = 0; i < pxConfig->uxNumTasks; i++) {
+        const TimelineTaskConfig_t *pxTask = &pxConfig->pxTasks[i];
+        UBaseType_t uxInstances;
+        uint32_t ulStart;
+        uint32_t ulEnd;
+
+        if (pxTask->xTaskType != TASK_TYPE_HARD_RT) {
+            // SRT jobs run once per frame, in whatever time is left
+            if (pxTask->ulPeriodTicks != 0) {
+                return pdFAIL;
+            }
+            pxStorage->usSoftTaskOrder[pxSchedule->uxSoftTaskCount++] = (uint16_t)i;
+            continue;
+        }
+        if (prvWindowUnits(pxTask, &ulStart, &ulEnd) != pdPASS ||
+            prvValidateMissPolicy(pxTask) != pdPASS) {
+            return pdFAIL;
+        }
+        uxInstances = prvInstanceCount(pxSchedule, pxTask, ulEnd);
+        if (uxInstances == 0) {
+            return pdFAIL;
+        }
+
+        // Each instance is released like a task of its own, only its slot is shared
+        for (UBaseType_t k = 0; k < uxInstances; k++) {
+            const uint32_t ulShift = k * pxTask->ulPeriodTicks * TIMELINE_UNITS_PER_TICK;
+
+            if (prvValidateHardTask(pxSchedule, pxTask, ulStart + ulShift, ulEnd + ulShift) != pdPASS ||
+                prvInsertEvent(pxSchedule, pxStorage->xEvents, ulStart + ulShift, TIMELINE_EVENT_RELEASE, i, k) != pdPASS ||
+                prvInsertEvent(pxSchedule, pxStorage->xEvents, ulEnd + ulShift, TIMELINE_EVENT_DEADLINE, i, k) != pdPASS) {
+                return pdFAIL;
+            }
+#if (TIMELINE_ABORT_LEAD_TICKS > 0)
+            // A window no longer than the lead would be asked to stop as it starts
+            if (ulEnd - ulStart > TIMELINE_ABORT_LEAD_TICKS * TIMELINE_UNITS_PER_TICK &&
+                prvInsertEvent(pxSchedule, pxStorage->xEvents,
+                               ulEnd + ulShift - TIMELINE_ABORT_LEAD_TICKS * TIMELINE_UNITS_PER_TICK,
+                               TIMELINE_EVENT_ABORT, i, k) != pdPASS) {
+                return pdFAIL;
+            }
+#endif
+        }
+    }
+
+    pxSchedule->pxEvents = pxStorage->xEvents;
+    pxSchedule->pusSoftTaskOrder = pxStorage->usSoftTaskOrder;
+    uxTableStorageCount++;
+    return pdPASS;
+#else
+    (void)pxSchedule;
+    (void)pxConfig;
+    return pdFAIL;
+#endif
+}
+
+/**
+ * @brief Compiles a configuration into a schedule: frame layout, sorted event
+ * table and SRT order.
+ *
+ * A table precompiled by TIMELINE_DEFINE() was sorted and checked by the
+ * compiler, so it is used in place; only the miss policies, whose handlers
+ * the compiler cannot see, are checked.
+ *
+ * @return pdPASS on success, pdFAIL if the configuration is invalid.
+ */
+static BaseType_t prvCompileSchedule(TimelineSchedule_t *pxSchedule, const TimelineConfig_t *pxConfig) {
+    if (pxConfig->pxTasks == NULL || pxConfig->uxNumTasks > MAX_TASKS) {
+        return pdFAIL;
+    }
+
+    pxSchedule->xConfig = *pxConfig;
+    pxSchedule->ulMajorFrameTicks = (pxConfig->ulMajorFrameTicks != 0) ? pxConfig->ulMajorFrameTicks
+                                                                         : MAJOR_FRAME_DURATION_TICKS;
+    pxSchedule->ulSubframeTicks = (pxConfig->ulSubframeTicks != 0) ? pxConfig->ulSubframeTicks
+                                                                     : SUBFRAME_DURATION_TICKS;
+
+    if (pxSchedule->ulSubframeTicks > pxSchedule->ulMajorFrameTicks ||
+        (pxSchedule->ulMajorFrameTicks % pxSchedule->ulSubframeTicks) != 0 ||
+        (pxSchedule->ulMajorFrameTicks / pxSchedule->ulSubframeTicks) > TIMELINE_MAX_SUBFRAMES) {
+        return pdFAIL;
+    }
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    // Checked here so that activating the schedule later cannot run out of stack space
+    uint32_t ulStackWords = 0;
+    for (UBaseType_t i = 0; i < pxConfig->uxNumTasks; i++) {
+        ulStackWords += prvStackDepth(&pxConfig->pxTasks[i]);
+    }
+    if (ulStackWords > TIMELINE_STACK_ARENA_WORDS) {
+        return pdFAIL;
+    }
+#endif
+
+    if (pxConfig->pxTable == NULL) {
+        return prvBuildTable(pxSchedule, pxConfig);
+    }
+
+    // Declared tasks are released once per frame; the table has no instances to match a period
+    for (UBaseType_t i = 0; i < pxConfig->uxNumTasks; i++) {
+        if (pxConfig->pxTasks[i].ulPeriodTicks != 0 ||
+            (pxConfig->pxTasks[i].xTaskType == TASK_TYPE_HARD_RT &&
+             prvValidateMissPolicy(&pxConfig->pxTasks[i]) != pdPASS)) {
+            return pdFAIL;
+        }
+    }
+    pxSchedule->pxEvents = pxConfig->pxTable->pxEvents;
+    pxSchedule->uxEventCount = pxConfig->pxTable->usEventCount;
+    pxSchedule->pusSoftTaskOrder = pxConfig->pxTable->pusSoftTaskOrder;
+    pxSchedule->uxSoftTaskCount = pxConfig->pxTable->usSoftTaskCount;
+    return pdPASS;
+}
+
+/**
+ * @brief Drops the registered schedules from uxFirst on, with their table storage.
+ */
+static void prvDropSchedules(UBaseType_t uxFirst) {
+    while (uxScheduleCount > uxFirst) {
+        uxScheduleCount--;
+        if (xSchedules[uxScheduleCount].xConfig.pxTable == NULL) {
+            uxTableStorageCount--;
+        }
+    }
+}
+
+/**
+ * @brief Binds the managed tasks to the entries of a compiled schedule.
+ *
+ * Only called while no job is running: at init, and at a frame boundary once
+ * every job of the previous frame has been reclaimed. Slot i is bound to entry
+ * i of the schedule; with the static pool its task is recreated in the slot's
+ * TCB buffer, on a stack carved from the arena in declaration order, so that
+ * its name, priority, stack and category match the new entry. Slots the
+ * schedule does not use are left empty. No heap memory is used.
+ *
+ * @return pdPASS, or pdFAIL if a pooled task could not be created.
+ */
+static BaseType_t prvActivateSchedule(const TimelineSchedule_t *pxSchedule) {
+    UBaseType_t uxNewCount = pxSchedule->xConfig.uxNumTasks;
+    UBaseType_t uxSlots = (uxNewCount > uxManagedTasksCount) ? uxNewCount : uxManagedTasksCount;
+    BaseType_t xResult = pdPASS;
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    uint32_t ulArenaOffset = 0;
+#endif
+
+    for (UBaseType_t i = 0; i < uxSlots; i++) {
+        ManagedTask_t *pxTask = &xManagedTasks[i];
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+        if (pxTask->xHandle != NULL) {
+            vTaskDelete(pxTask->xHandle);
+            pxTask->xHandle = NULL;
+        }
+#endif
+        pxTask->pxConfig = (i < uxNewCount) ? &pxSchedule->xConfig.pxTasks[i] : NULL;
+        pxTask->ucIsActive = pdFALSE;
+        pxTask->ucCompleted = pdFALSE;
+#if (TIMELINE_TICK_DISPATCH == 1)
+        pxTask->ucKillPending = pdFALSE;
+        pxTask->ucNotifyPending = 0U;
+        pxTask->ucNotifyQueued = pdFALSE;
+#endif
+        // Miss policies act on the releases of one schedule; the counters carry over
+        pxTask->ulSkipRemaining = 0;
+        pxTask->ucDegraded = pdFALSE;
+        pxTask->ucAbortRequested = pdFALSE;
+        pxTask->ucResourceCount = 0;
+        pxTask->ucInstance = 0;
+
+        if (pxTask->pxConfig == NULL) {
+            continue;
+        }
+        vTraceSetTaskName((uint16_t)i, pxTask->pxConfig->pcName);
+        pxTask->ulStackDepth = prvStackDepth(pxTask->pxConfig);
+        pxTask->pvJobCode = pxTask->pxConfig->pvTaskCode;
+        if (pxTask->pxConfig->xTaskType == TASK_TYPE_HARD_RT) {
+            uint32_t ulStart;
+
+            // Validated when the schedule was registered
+            (void)prvWindowUnits(pxTask->pxConfig, &ulStart, &pxTask->ulDeadline);
+        }
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+        // The total was checked against the arena size at registration
+        pxTask->pxStack = &xJobStackArena[ulArenaOffset];
+        ulArenaOffset += pxTask->ulStackDepth;
+        if (prvCreateJobTask(pxTask) != pdPASS) {
+            xResult = pdFAIL;
+        }
+#endif
+    }
+
+#if (TIMELINE_TICK_DISPATCH == 1)
+    // The kill and notification marks were all cleared above, and the old tasks
+    // that could still owe their deferred notifications deleted
+    uxKillHead = 0;
+    uxKillTail = 0;
+    uxNotifyCount = 0;
+    xNotifyReaper = pdFALSE;
+#endif
+    pxActiveSchedule = pxSchedule;
+    uxManagedTasksCount = uxNewCount;
+    return xResult;
+}
+
+/**
+ * @brief Applies the pending schedule switch, if any, at a frame boundary.
+ *
+ * The switch itself is a table swap plus the rebinding of the job slots; the
+ * trace record carries the ticks elapsed since the request.
+ */
+static void prvApplyPendingSwitch(void) {
+    UBaseType_t uxRequested;
+    TickType_t xRequestTick;
+
+    taskENTER_CRITICAL();
+    uxRequested = uxPendingSchedule;
+    xRequestTick = xSwitchRequestTick;
+    uxPendingSchedule = TIMELINE_NO_PENDING_SWITCH;
+    taskEXIT_CRITICAL();
+
+    if (uxRequested == TIMELINE_NO_PENDING_SWITCH || &xSchedules[uxRequested] == pxActiveSchedule) {
+        return;
+    }
+
+    // Cannot fail: pooled tasks are recreated in static buffers that were just released
+    (void)prvActivateSchedule(&xSchedules[uxRequested]);
+    vTraceLog(TRACE_EVENT_SCHEDULE_SWITCH, TRACE_TASK_ID_SCHEDULER, xTaskGetTickCount(),
+              xTaskGetTickCount() - xRequestTick);
+}
+
+/**
+ * @brief Rewinds the frame arena and restores the registered state blocks at
+ * the start of a major frame.
+ *
+ * Runs before any job of the frame is released, in the scheduler task or in
+ * the dispatcher interrupt. The state pass is traced with its cost in cycles.
+ *
+ * @param xNow Current tick.
+ */
+static void prvResetFrameState(TickType_t xNow) {
+#if (TIMELINE_ARENA_PER_SUBFRAME == 0)
+    vTimelineArenaReset();
+#endif
+
+    if (uxTimelineStateGetCount() == 0) {
+        return;
+    }
+
+    vTimelineStatsStateResetStart();
+    (void)xTimelineStateRestore();
+    vTraceLog(TRACE_EVENT_STATE_RESET, TRACE_TASK_ID_SCHEDULER, xNow, ulTimelineStatsStateResetEnd());
+}
+
+#if (TIMELINE_TICK_DISPATCH == 0)
+
+/**
+ * @brief Detects a late start of the major frame beginning at xFrameEpoch.
+ *
+ * The epoch always advances by exactly one major frame, in the manner of
+ * vTaskDelayUntil(), so lateness in one frame never shifts the
+ * releases of the following ones. When the previous frame ran past this
+ * boundary the overrun is reported; if whole frames were missed the epoch is
+ * moved forward by that many frames so that the timeline stays on its grid.
+ *
+ * @param xNow Current tick.
+ */
+static void prvCheckFrameOverrun(TickType_t xNow) {
+    TickType_t xLateness = xNow - xFrameEpoch;
+
+    if (xLateness == 0) {
+        return;
+    }
+
+    ulFrameOverrunCount++;
+    vTraceLog(TRACE_EVENT_FRAME_OVERRUN, TRACE_TASK_ID_SCHEDULER, xNow, xLateness);
+
+    if (xLateness >= pxActiveSchedule->ulMajorFrameTicks) {
+        xFrameEpoch += (xLateness / pxActiveSchedule->ulMajorFrameTicks) * pxActiveSchedule->ulMajorFrameTicks;
+    }
+}
+
+/**
+ * @brief Starts one execution of a managed job.
+ *
+ * @param pxTask The job to start.
+ * @param xReleaseTick Nominal release instant, used to measure the release latency.
+ * @return pdPASS if the job was started, pdFAIL if its task could not be created.
+ */
+static BaseType_t prvStartJob(ManagedTask_t *pxTask, TickType_t xReleaseTick) {
+    BaseType_t xDegraded = prvSelectJobCode(pxTask);
+
+    pxTask->ucCompleted = pdFALSE;
+    pxTask->ucAbortRequested = pdFALSE;
+    vTimelineStatsRelease(prvTaskIndex(pxTask), xReleaseTick);
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    // The pooled task is waiting in its wrapper; releasing it is a single notification
+    xTaskNotifyGiveIndexed(pxTask->xHandle, TIMELINE_NOTIFY_INDEX);
+#else
+    // A new task is created for each execution, as per the project requirements (start-to-end execution)
+    xTaskCreate(prvJobWrapper,
+                pxTask->pxConfig->pcName,
+                (configSTACK_DEPTH_TYPE)pxTask->ulStackDepth,
+                pxTask,
+                prvJobPriority(pxTask),
+                &pxTask->xHandle);
+
+    if (pxTask->xHandle == NULL) {
+        // The release cannot start on time, like one finding the CPU busy
+        pxTask->xCounters.ulOverruns++;
+        prvTraceJob(TRACE_EVENT_TASK_CREATE_FAILED, pxTask, xTaskGetTickCount(), 0);
+        return pdFAIL;
+    }
+    vTimelineStatsTagTask(pxTask->xHandle, prvJobCategory(pxTask));
+#endif
+
+    prvTraceJob(TRACE_EVENT_TASK_SPAWN, pxTask, xTaskGetTickCount(), (uint32_t)xDegraded);
+    pxTask->ucIsActive = pdTRUE;
+    return pdPASS;
+}
+
+/**
+ * @brief Starts the next SRT job in compile-time order, if any is left.
+ *
+ * Only one SRT job exists at a time. It runs at TIMELINE_SRT_PRIORITY, so it
+ * only gets the CPU in the gaps left by HRT jobs and is preempted by the next
+ * HRT release without any action from the scheduler.
+ */
+static void prvStartNextSoftJob(void) {
+    while (pxActiveSoftJob == NULL && uxNextSoftTask < pxActiveSchedule->uxSoftTaskCount) {
+        ManagedTask_t *pxTask = &xManagedTasks[pxActiveSchedule->pusSoftTaskOrder[uxNextSoftTask]];
+
+        uxNextSoftTask++;
+        if (prvStartJob(pxTask, xTaskGetTickCount()) == pdPASS) {
+            pxActiveSoftJob = pxTask;
+        }
+    }
+}
+
+/**
+ * @brief Reclaims the active HRT and SRT jobs if they have signalled completion.
+ */
+static void prvCheckCompletion(void) {
+    if (pxActiveJob != NULL && pxActiveJob->ucCompleted != pdFALSE) {
+        prvReclaimJob(pxActiveJob, pdFALSE);
+        prvJobReturned(pxActiveJob, xTaskGetTickCount());
+        pxActiveJob = NULL;
+    }
+
+    if (pxActiveSoftJob != NULL && pxActiveSoftJob->ucCompleted != pdFALSE) {
+        prvReclaimJob(pxActiveSoftJob, pdFALSE);
+        prvJobReturned(pxActiveSoftJob, xTaskGetTickCount());
+        pxActiveSoftJob = NULL;
+        prvStartNextSoftJob();
+    }
+}
+
+/**
+ * @brief Ends the SRT phase of a major frame.
+ *
+ * SRT jobs carry no completion guarantee. The job still running at the end of
+ * the frame is terminated so that the next frame starts from a clean state,
+ * and it is reported together with every SRT job that never got to start.
+ */
+static void prvEndSoftJobs(void) {
+    if (pxActiveSoftJob != NULL) {
+        vTraceLog(TRACE_EVENT_SRT_INCOMPLETE, prvTaskIndex(pxActiveSoftJob), xTaskGetTickCount(), 0);
+        prvReclaimJob(pxActiveSoftJob, pdTRUE);
+        pxActiveSoftJob = NULL;
+    }
+
+    while (uxNextSoftTask < pxActiveSchedule->uxSoftTaskCount) {
+        vTraceLog(TRACE_EVENT_SRT_INCOMPLETE, pxActiveSchedule->pusSoftTaskOrder[uxNextSoftTask], xTaskGetTickCount(), 0);
+        uxNextSoftTask++;
+    }
+
+    uxNextSoftTask = 0;
+}
+
+/**
+ * @brief Returns the number of ticks left until an absolute tick.
+ *
+ * The difference is computed modulo the tick counter width, so the result
+ * stays correct when TickType_t overflows. Targets more than half the counter
+ * range away are taken to be in the past.
+ *
+ * @param xTargetTick Absolute tick to compare against the current tick count.
+ * @return The remaining ticks, or 0 if the target has been reached.
+ */
+static TickType_t prvTicksUntil(TickType_t xTargetTick) {
+    TickType_t xRemaining = xTargetTick - xTaskGetTickCount();
+
+    if (xRemaining > (portMAX_DELAY >> 1)) {
+        return 0;
+    }
+    return xRemaining;
+}
+
+/**
+ * @brief Sleeps until the given tick, servicing job completions meanwhile.
+ *
+ * The scheduler blocks in a single timed wait on its notification and is only
+ * woken by a job wrapper or by the timeout at the next event, so its CPU use
+ * does not depend on the length of the windows.
+ *
+ * @param xWakeTick Absolute tick of the next timeline event.
+ */
+static void prvSleepUntil(TickType_t xWakeTick) {
+    for (;;) {
+        prvCheckCompletion();
+
+        TickType_t xRemaining = prvTicksUntil(xWakeTick);
+        if (xRemaining == 0) {
+            return;
+        }
+
+        vTimelineStatsSchedulerSleep();
+        (void)ulTaskNotifyTakeIndexed(TIMELINE_NOTIFY_INDEX, pdTRUE, xRemaining);
+        vTimelineStatsSchedulerWake();
+    }
+}
+
+/**
+ * @brief Spawns the job of a released HRT task, unless prvAdmitRelease() skips it.
+ *
+ * @param pxTask The released task.
+ * @param xReleaseTick Nominal release instant.
+ */
+static void prvReleaseJob(ManagedTask_t *pxTask, TickType_t xReleaseTick) {
+    TickType_t xNow = xTaskGetTickCount();
+
+    if (prvAdmitRelease(pxTask, (pxActiveJob != NULL) ? pdTRUE : pdFALSE, xNow - xFrameEpoch, xNow) == pdFALSE) {
+        return;
+    }
+
+    if (prvStartJob(pxTask, xReleaseTick) == pdPASS) {
+        pxActiveJob = pxTask;
+    }
+}
+
+/**
+ * @brief Terminates an HRT job that is still running at its deadline, then
+ * applies its miss policy.
+ */
+static void prvEnforceDeadline(ManagedTask_t *pxTask) {
+    if (pxTask->ucIsActive == pdFALSE) {
+        return;
+    }
+
+    prvTraceJob(TRACE_EVENT_DEADLINE_MISS, pxTask, xTaskGetTickCount(), 0);
+    prvReclaimJob(pxTask, pdTRUE);
+    pxActiveJob = NULL;
+    prvApplyMissPolicy(pxTask);
+}
+
+/**
+ * @brief The main scheduler task.
+ *
+ * This high-priority task manages the entire timeline, including the major frame
+ * cycle and the spawning/termination of HRT and SRT tasks. Each frame it walks
+ * the precompiled event table of the active schedule once, doing constant
+ * work per event, and switches schedules only between two frames.
+ *
+ * @param pvParameters Unused.
+ */
+static void prvSchedulerTask(void *pvParameters) {
+    (void)pvParameters;
+
+    // This task starts automatically after vTaskStartScheduler() is called.
+    vTimelineSchedulerStart();
+
+    // The idle task only exists once the kernel has started
+    vTimelineStatsTagTask(xTaskGetIdleTaskHandle(), TIMELINE_UTIL_IDLE);
+
+    // All releases and frame boundaries are anchored to this epoch
+    xFrameEpoch = xTaskGetTickCount();
+    vTimelineStatsReset();
+    vTimelineArenaClearStats();
+
+    for (;;) {
+        prvCheckFrameOverrun(xTaskGetTickCount());
+        ulFrameCount++;
+        vTraceLog(TRACE_EVENT_MAJOR_FRAME_START, TRACE_TASK_ID_SCHEDULER, xTaskGetTickCount(), 0);
+        prvResetFrameState(xTaskGetTickCount());
+
+        // SRT jobs fill whatever time the HRT jobs leave idle, from the start of the frame
+        prvStartNextSoftJob();
+
+        // --- HRT Task Scheduling Phase ---
+        for (UBaseType_t uxEvent = 0; uxEvent < pxActiveSchedule->uxEventCount; uxEvent++) {
+            const TimelineEvent_t *pxEvent = &pxActiveSchedule->pxEvents[uxEvent];
+
+            prvSleepUntil(xFrameEpoch + pxEvent->ulOffset);
+
+            switch (pxEvent->ucKind) {
+                case TIMELINE_EVENT_DEADLINE:
+                    prvEnforceDeadline(&xManagedTasks[pxEvent->usIndex]);
+                    break;
+                case TIMELINE_EVENT_SUBFRAME:
+                    vTraceLog(TRACE_EVENT_SUBFRAME_START, TRACE_TASK_ID_SCHEDULER, xTaskGetTickCount(), pxEvent->usIndex);
+                    vTimelineStatsSubframeStart(pxEvent->usIndex);
+#if (TIMELINE_ARENA_PER_SUBFRAME == 1)
+                    vTimelineArenaReset();
+#endif
+                    break;
+                case TIMELINE_EVENT_RELEASE:
+                    xManagedTasks[pxEvent->usIndex].ucInstance = pxEvent->ucInstance;
+                    prvReleaseJob(&xManagedTasks[pxEvent->usIndex], xFrameEpoch + pxEvent->ulOffset);
+                    break;
+                case TIMELINE_EVENT_ABORT:
+                    if (prvRequestAbort(&xManagedTasks[pxEvent->usIndex], xTaskGetTickCount()) != pdFALSE) {
+                        xTaskNotifyGiveIndexed(xManagedTasks[pxEvent->usIndex].xHandle, TIMELINE_ABORT_NOTIFY_INDEX);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // --- Final Idle Phase ---
+        // No HRT work is left in this frame; SRT jobs keep running until its end.
+        vTraceLog(TRACE_EVENT_IDLE_START, TRACE_TASK_ID_SCHEDULER, xTaskGetTickCount(), 0);
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_DUMP_PERIOD_FRAMES > 0)
+        if (++ulFramesSinceDump >= TIMELINE_STATS_DUMP_PERIOD_FRAMES) {
+            ulFramesSinceDump = 0;
+            vTimelineStatsDump();
+        }
+#endif
+
+        // Wait for the end of the major frame
+        prvSleepUntil(xFrameEpoch + pxActiveSchedule->ulMajorFrameTicks);
+        vTraceLog(TRACE_EVENT_IDLE_END, TRACE_TASK_ID_SCHEDULER, xTaskGetTickCount(), 0);
+
+        prvEndSoftJobs();
+        vTimelineStatsFrameEnd();
+
+        xFrameEpoch += pxActiveSchedule->ulMajorFrameTicks;
+
+        // Every job is idle here, so the next frame may follow another schedule
+        prvApplyPendingSwitch();
+    }
+}
+
+#else /* TIMELINE_TICK_DISPATCH */
+
+/**
+ * @brief Returns the current time of the dispatcher, in event table units.
  */
-typedef struct {
-    const TimelineTaskConfig_t *pxConfig; /**< Pointer to the public task configuration. */
-    TaskHandle_t xHandle;                 /**< Handle of the FreeRTOS task. */
-    BaseType_t xIsActive;                 /**< Flag to indicate if the task is currently running. */
-} ManagedTask_t;
+static uint32_t prvDispatchNow(void) {
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    return ulTimelineTimerNow();
+#else
+    return xDispatchTick;
+#endif
+}
 
-// --- Private State ---
+/**
+ * @brief Returns the tick of the current instant, for the trace.
+ *
+ * With the one-shot timer it is derived from the timer clock, as the kernel's
+ * tick count is only brought up to date after a tickless sleep.
+ */
+static TickType_t prvDispatchTick(void) {
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    return xFrameEpoch + (TickType_t)((ulTimelineTimerNow() - ulDispatchEpoch) / TIMELINE_UNITS_PER_TICK);
+#else
+    return xDispatchTick;
+#endif
+}
 
-static TimelineConfig_t xSchedulerConfig;
-static ManagedTask_t xManagedTasks[MAX_TASKS];
-static UBaseType_t uxManagedTasksCount = 0;
-static TaskHandle_t xSchedulerTaskHandle = NULL;
+/**
+ * @brief Arms the one-shot timer for an absolute time, in event table units.
+ *
+ * The tick hook polls instead, so this does nothing without the one-shot timer.
+ */
+static void prvDispatchArm(uint32_t ulTarget) {
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    vTimelineTimerArm(ulTarget);
+#else
+    (void)ulTarget;
+#endif
+}
 
-// --- Private Functions ---
+/**
+ * @brief Gives a notification on behalf of the dispatcher.
+ *
+ * From the interrupt the notification is given at once. The reaper and the
+ * job wrappers run the dispatcher in a critical section, where the FromISR
+ * call is not meant to be used; the notification is queued instead, and
+ * given by prvFlushNotifications() once the section is left.
+ *
+ * @param pxTask The job to notify, or NULL for the reaper.
+ * @param uxIndexToNotify TIMELINE_NOTIFY_INDEX or TIMELINE_ABORT_NOTIFY_INDEX.
+ */
+static void prvDispatchNotify(ManagedTask_t *pxTask, UBaseType_t uxIndexToNotify) {
+    if (xDispatchInISR != pdFALSE) {
+        vTaskNotifyGiveIndexedFromISR((pxTask != NULL) ? pxTask->xHandle : xSchedulerTaskHandle, uxIndexToNotify,
+                                      &xDispatchWoken);
+    } else if (pxTask == NULL) {
+        xNotifyReaper = pdTRUE;
+    } else {
+        if (pxTask->ucNotifyQueued == pdFALSE) {
+            pxTask->ucNotifyQueued = pdTRUE;
+            usNotifyQueue[uxNotifyCount++] = prvTaskIndex(pxTask);
+        }
+        pxTask->ucNotifyPending |= (uint8_t)(1U << uxIndexToNotify);
+    }
+}
 
 /**
- * @brief The main scheduler task.
+ * @brief Gives the notifications deferred by prvDispatchNotify().
  *
- * This high-priority task manages the entire timeline, including the major frame
- * cycle and the spawning/termination of HRT and SRT tasks.
+ * Called from task context after the critical section that ran the
+ * dispatcher. The scheduler stays suspended meanwhile, so the reaper cannot
+ * recreate a job between taking its notifications and giving them; a job
+ * killed since then is skipped, as the reaper restarts it if needed.
+ */
+static void prvFlushNotifications(void) {
+    BaseType_t xReaper;
+
+    vTaskSuspendAll();
+    for (;;) {
+        ManagedTask_t *pxTask;
+        uint8_t ucPending;
+
+        taskENTER_CRITICAL();
+        if (uxNotifyCount == 0) {
+            xReaper = xNotifyReaper;
+            xNotifyReaper = pdFALSE;
+            taskEXIT_CRITICAL();
+            break;
+        }
+        pxTask = &xManagedTasks[usNotifyQueue[--uxNotifyCount]];
+        ucPending = (pxTask->ucKillPending == pdFALSE) ? pxTask->ucNotifyPending : 0U;
+        pxTask->ucNotifyPending = 0U;
+        pxTask->ucNotifyQueued = pdFALSE;
+        taskEXIT_CRITICAL();
+
+        if ((ucPending & (1U << TIMELINE_NOTIFY_INDEX)) != 0U) {
+            xTaskNotifyGiveIndexed(pxTask->xHandle, TIMELINE_NOTIFY_INDEX);
+        }
+        if ((ucPending & (1U << TIMELINE_ABORT_NOTIFY_INDEX)) != 0U) {
+            xTaskNotifyGiveIndexed(pxTask->xHandle, TIMELINE_ABORT_NOTIFY_INDEX);
+        }
+    }
+    if (xReaper != pdFALSE) {
+        xTaskNotifyGiveIndexed(xSchedulerTaskHandle, TIMELINE_NOTIFY_INDEX);
+    }
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @brief Terminates a job from the dispatcher interrupt.
  *
- * @param pvParameters Unused.
+ * A task cannot be deleted from an interrupt, so the job is only marked and
+ * the reaper is woken. The reaper runs above every job, so the killed job
+ * never executes again: it is deleted and recreated as soon as the interrupt
+ * returns.
  */
-static void prvSchedulerTask(void *pvParameters) {
-    TickType_t xMajorFrameStartTick;
+static void prvTickKill(ManagedTask_t *pxTask) {
+    vTimelineStatsJobEnd(prvTaskIndex(pxTask), pdTRUE);
+    pxTask->ucIsActive = pdFALSE;
 
-    // This task starts automatically after vTaskStartScheduler() is called.
-    vTimelineSchedulerStart();
+    // A job killed again before it was reaped is still queued once, and its task recreated once
+    if (pxTask->ucKillPending == pdFALSE) {
+        pxTask->ucKillPending = pdTRUE;
+        usKillQueue[uxKillTail] = prvTaskIndex(pxTask);
+        uxKillTail = (uxKillTail == MAX_TASKS) ? 0 : uxKillTail + 1;
+    }
+    prvDispatchNotify(NULL, TIMELINE_NOTIFY_INDEX);
+}
+
+/**
+ * @brief Releases a job with a notification to its pooled task.
+ *
+ * A job killed earlier in the same tick is restarted by the reaper once its
+ * task has been recreated, as a notification sent now would be lost.
+ *
+ * @param pxTask The job to start.
+ * @param ulLateness Time since the nominal release instant, in event table units.
+ */
+static void prvTickStartJob(ManagedTask_t *pxTask, uint32_t ulLateness) {
+    BaseType_t xDegraded = prvSelectJobCode(pxTask);
+
+    pxTask->ucCompleted = pdFALSE;
+    pxTask->ucIsActive = pdTRUE;
+    pxTask->ucAbortRequested = pdFALSE;
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    // Timer cycles are CPU cycles, the unit of the statistics
+    vTimelineStatsReleaseElapsed(prvTaskIndex(pxTask), ulLateness);
+#else
+    vTimelineStatsRelease(prvTaskIndex(pxTask), xDispatchTick - ulLateness);
+#endif
+
+    if (pxTask->ucKillPending == pdFALSE) {
+        prvDispatchNotify(pxTask, TIMELINE_NOTIFY_INDEX);
+    }
+    prvTraceJob(TRACE_EVENT_TASK_SPAWN, pxTask, prvDispatchTick(), (uint32_t)xDegraded);
+}
+
+/**
+ * @brief Starts the next SRT job in declaration order, if none is running.
+ */
+static void prvTickStartNextSoftJob(void) {
+    if (pxActiveSoftJob == NULL && uxNextSoftTask < pxActiveSchedule->uxSoftTaskCount) {
+        pxActiveSoftJob = &xManagedTasks[pxActiveSchedule->pusSoftTaskOrder[uxNextSoftTask]];
+        uxNextSoftTask++;
+        prvTickStartJob(pxActiveSoftJob, 0);
+    }
+}
+
+/**
+ * @brief Books the completion of a job. Called by its wrapper with interrupts masked.
+ */
+static void prvTickJobCompleted(ManagedTask_t *pxTask) {
+    pxTask->ucCompleted = pdTRUE;
+    pxTask->ucIsActive = pdFALSE;
+    prvJobReturned(pxTask, prvDispatchTick());
+
+    if (pxTask == pxActiveJob) {
+        pxActiveJob = NULL;
+    } else if (pxTask == pxActiveSoftJob) {
+        pxActiveSoftJob = NULL;
+        prvTickStartNextSoftJob();
+    }
+}
+
+/**
+ * @brief Ends the SRT phase of a major frame, as prvEndSoftJobs() does.
+ */
+static void prvTickEndSoftJobs(void) {
+    TickType_t xNow = prvDispatchTick();
+
+    if (pxActiveSoftJob != NULL) {
+        prvTickKill(pxActiveSoftJob);
+        vTraceLog(TRACE_EVENT_SRT_INCOMPLETE, prvTaskIndex(pxActiveSoftJob), xNow, 0);
+        pxActiveSoftJob = NULL;
+    }
+
+    while (uxNextSoftTask < pxActiveSchedule->uxSoftTaskCount) {
+        vTraceLog(TRACE_EVENT_SRT_INCOMPLETE, pxActiveSchedule->pusSoftTaskOrder[uxNextSoftTask], xNow, 0);
+        uxNextSoftTask++;
+    }
+
+    uxNextSoftTask = 0;
+}
+
+/**
+ * @brief Opens the major frame beginning at ulDispatchEpoch.
+ *
+ * Detects a late start as prvCheckFrameOverrun() does, in event table units.
+ * A start less than a tick late is not an overrun: with the one-shot timer
+ * the interrupt latency alone makes every frame start a few cycles late.
+ */
+static void prvTickStartFrame(void) {
+    const uint32_t ulMajorFrameUnits = pxActiveSchedule->ulMajorFrameTicks * TIMELINE_UNITS_PER_TICK;
+    uint32_t ulLateness = prvDispatchNow() - ulDispatchEpoch;
+
+    if (ulLateness >= TIMELINE_UNITS_PER_TICK) {
+        ulFrameOverrunCount++;
+        vTraceLog(TRACE_EVENT_FRAME_OVERRUN, TRACE_TASK_ID_SCHEDULER, prvDispatchTick(),
+                  ulLateness / TIMELINE_UNITS_PER_TICK);
+
+        if (ulLateness >= ulMajorFrameUnits) {
+            uint32_t ulFrames = ulLateness / ulMajorFrameUnits;
+
+            ulDispatchEpoch += ulFrames * ulMajorFrameUnits;
+            xFrameEpoch += ulFrames * pxActiveSchedule->ulMajorFrameTicks;
+        }
+    }
+
+    ulFrameCount++;
+    vTraceLog(TRACE_EVENT_MAJOR_FRAME_START, TRACE_TASK_ID_SCHEDULER, prvDispatchTick(), 0);
+    prvResetFrameState(prvDispatchTick());
+    uxNextEvent = 0;
+    prvTickStartNextSoftJob();
+}
+
+/**
+ * @brief Processes every event that is due, then arms the one-shot timer for the next one.
+ *
+ * Runs in the tick or timer interrupt, or in the reaper with interrupts
+ * masked. Events missed because the interrupt came late are processed late
+ * rather than dropped, and the frame boundary is checked like any other event.
+ */
+static void prvTickDispatch(void) {
+    const uint32_t ulNow = prvDispatchNow();
 
     for (;;) {
-        xMajorFrameStartTick = xTaskGetTickCount();
-        vTraceLog(TRACE_EVENT_MAJOR_FRAME_START, "Scheduler", xMajorFrameStartTick);
+        uint32_t ulIntoFrame = ulNow - ulDispatchEpoch;
 
-        // --- HRT Task Scheduling Phase ---
-        for (UBaseType_t i = 0; i < uxManagedTasksCount; i++) {
-            if (xManagedTasks[i].pxConfig->xTaskType == TASK_TYPE_HARD_RT) {
-                TickType_t xCurrentTick = xTaskGetTickCount();
-                TickType_t xStartTime = xMajorFrameStartTick + xManagedTasks[i].pxConfig->ulStartTimeTicks;
-                
-                // Wait until the task's start time
-                if (xCurrentTick < xStartTime) {
-                    vTaskDelay(xStartTime - xCurrentTick);
-                }
+        if (uxNextEvent < pxActiveSchedule->uxEventCount) {
+            const TimelineEvent_t *pxEvent = &pxActiveSchedule->pxEvents[uxNextEvent];
+            ManagedTask_t *pxTask = &xManagedTasks[pxEvent->usIndex];
 
-                // Spawn the HRT task
-                // A new task is created for each execution, as per the project requirements (start-to-end execution)
-                xTaskCreate(xManagedTasks[i].pxConfig->pvTaskCode,
-                            xManagedTasks[i].pxConfig->pcName,
-                            configMINIMAL_STACK_SIZE,
-                            NULL,
-                            tskIDLE_PRIORITY + 2, // Higher priority than scheduler to run immediately
-                            &xManagedTasks[i].xHandle);
-                
-                if (xManagedTasks[i].xHandle == NULL) {
-                    vTraceLog(TRACE_EVENT_TASK_CREATE_FAILED, xManagedTasks[i].pxConfig->pcName, xTaskGetTickCount());
-                    continue; // Skip to next task if creation failed
-                }
+            if (ulIntoFrame < pxEvent->ulOffset) {
+                prvDispatchArm(ulDispatchEpoch + pxEvent->ulOffset);
+                return;
+            }
+            uxNextEvent++;
 
-                vTraceLog(TRACE_EVENT_TASK_SPAWN, xManagedTasks[i].pxConfig->pcName, xTaskGetTickCount());
-                xManagedTasks[i].xIsActive = pdTRUE;
-
-                // Monitor for deadline
-                TickType_t xDeadline = xMajorFrameStartTick + xManagedTasks[i].pxConfig->ulEndTimeTicks;
-                
-                // Loop to check for task completion or deadline miss
-                while (xManagedTasks[i].xIsActive) {
-                    // Check if the task has completed by deleting itself
-                    // eTaskGetState is not perfectly reliable for this, a better approach would be a notification
-                    if (eTaskGetState(xManagedTasks[i].xHandle) == eDeleted) {
-                        xManagedTasks[i].xIsActive = pdFALSE;
-                        vTraceLog(TRACE_EVENT_TASK_COMPLETE, xManagedTasks[i].pxConfig->pcName, xTaskGetTickCount());
-                        break; // Exit while loop
+            switch (pxEvent->ucKind) {
+                case TIMELINE_EVENT_DEADLINE:
+                    if (pxTask->ucIsActive != pdFALSE) {
+                        prvTickKill(pxTask);
+                        pxActiveJob = NULL;
+                        prvTraceJob(TRACE_EVENT_DEADLINE_MISS, pxTask, prvDispatchTick(), 0);
+                        prvApplyMissPolicy(pxTask);
                     }
-
-                    // Check if the deadline is reached
-                    if (xTaskGetTickCount() >= xDeadline) {
-                        vTaskDelete(xManagedTasks[i].xHandle);
-                        xManagedTasks[i].xIsActive = pdFALSE;
-                        vTraceLog(TRACE_EVENT_DEADLINE_MISS, xManagedTasks[i].pxConfig->pcName, xTaskGetTickCount());
-                        break; // Exit while loop
+                    break;
+                case TIMELINE_EVENT_SUBFRAME:
+                    vTraceLog(TRACE_EVENT_SUBFRAME_START, TRACE_TASK_ID_SCHEDULER, prvDispatchTick(),
+                              pxEvent->usIndex);
+                    vTimelineStatsSubframeStart(pxEvent->usIndex);
+#if (TIMELINE_ARENA_PER_SUBFRAME == 1)
+                    vTimelineArenaReset();
+#endif
+                    break;
+                case TIMELINE_EVENT_RELEASE:
+                    pxTask->ucInstance = pxEvent->ucInstance;
+                    if (prvAdmitRelease(pxTask, (pxActiveJob != NULL) ? pdTRUE : pdFALSE, ulIntoFrame,
+                                        prvDispatchTick()) != pdFALSE) {
+                        pxActiveJob = pxTask;
+                        prvTickStartJob(pxTask, ulIntoFrame - pxEvent->ulOffset);
+                    }
+                    break;
+                case TIMELINE_EVENT_ABORT:
+                    // A task waiting to be reaped would lose the notification; the flag still holds
+                    if (prvRequestAbort(pxTask, prvDispatchTick()) != pdFALSE && pxTask->ucKillPending == pdFALSE) {
+                        prvDispatchNotify(pxTask, TIMELINE_ABORT_NOTIFY_INDEX);
                     }
-                    
-                    // Small delay to prevent this loop from consuming 100% CPU
-                    vTaskDelay(1);
+                    break;
+                default:
+                    break;
+            }
+
+            if (uxNextEvent == pxActiveSchedule->uxEventCount) {
+                vTraceLog(TRACE_EVENT_IDLE_START, TRACE_TASK_ID_SCHEDULER, prvDispatchTick(), 0);
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_DUMP_PERIOD_FRAMES > 0)
+                if (++ulFramesSinceDump >= TIMELINE_STATS_DUMP_PERIOD_FRAMES) {
+                    ulFramesSinceDump = 0;
+                    xDumpPending = pdTRUE;
+                    prvDispatchNotify(NULL, TIMELINE_NOTIFY_INDEX);
                 }
+#endif
             }
+            continue;
         }
 
-        // --- SRT Task Scheduling Phase ---
-        // This phase would run SRT tasks in the remaining time.
-        // For simplicity in this first step, this is left as a placeholder.
-        vTraceLog(TRACE_EVENT_IDLE_START, "Scheduler", xTaskGetTickCount());
-        
-        // Wait for the end of the major frame
-        TickType_t xMajorFrameEndTick = xMajorFrameStartTick + MAJOR_FRAME_DURATION_TICKS;
-        TickType_t xCurrentTick = xTaskGetTickCount();
-        if (xCurrentTick < xMajorFrameEndTick) {
-            vTaskDelay(xMajorFrameEndTick - xCurrentTick);
+        if (ulIntoFrame < pxActiveSchedule->ulMajorFrameTicks * TIMELINE_UNITS_PER_TICK) {
+            prvDispatchArm(ulDispatchEpoch + pxActiveSchedule->ulMajorFrameTicks * TIMELINE_UNITS_PER_TICK);
+            return;
+        }
+
+        // --- Frame boundary ---
+        vTraceLog(TRACE_EVENT_IDLE_END, TRACE_TASK_ID_SCHEDULER, prvDispatchTick(), 0);
+        prvTickEndSoftJobs();
+        vTimelineStatsFrameEnd();
+        ulDispatchEpoch += pxActiveSchedule->ulMajorFrameTicks * TIMELINE_UNITS_PER_TICK;
+        xFrameEpoch += pxActiveSchedule->ulMajorFrameTicks;
+
+        // Rebinding the job tasks cannot be done here; hold the timeline for the reaper
+        if (uxPendingSchedule != TIMELINE_NO_PENDING_SWITCH) {
+            xBoundaryPending = pdTRUE;
+            prvDispatchNotify(NULL, TIMELINE_NOTIFY_INDEX);
+            return;
+        }
+        prvTickStartFrame();
+    }
+}
+
+/**
+ * @brief Runs the dispatcher from the tick or timer interrupt.
+ *
+ * @return pdTRUE if a task of higher priority than the interrupted one was woken.
+ */
+static BaseType_t prvDispatchFromISR(void) {
+    xDispatchWoken = pdFALSE;
+    if (xDispatchRunning == pdFALSE || xBoundaryPending != pdFALSE) {
+        return pdFALSE;
+    }
+
+    // The dispatcher's time is accounted as scheduler time
+    vTimelineStatsSchedulerWake();
+    xDispatchInISR = pdTRUE;
+    prvTickDispatch();
+    xDispatchInISR = pdFALSE;
+    vTimelineStatsSchedulerSleep();
+    return xDispatchWoken;
+}
+
+/**
+ * @brief Recreates the tasks of the jobs killed by the dispatcher.
+ *
+ * Takes them from the kill queue, so the work is proportional to the kills,
+ * not to the number of tasks.
+ */
+static void prvReapKilledJobs(void) {
+    for (;;) {
+        ManagedTask_t *pxTask;
+        uint16_t usIndex;
+        TaskHandle_t xJob;
+        BaseType_t xRestart;
+
+        taskENTER_CRITICAL();
+        if (uxKillHead == uxKillTail) {
+            taskEXIT_CRITICAL();
+            return;
+        }
+        usIndex = usKillQueue[uxKillHead];
+        uxKillHead = (uxKillHead == MAX_TASKS) ? 0 : uxKillHead + 1;
+        taskEXIT_CRITICAL();
+
+        pxTask = &xManagedTasks[usIndex];
+        xJob = pxTask->xHandle;
+        vTimelineStatsStackCheck(usIndex, xJob, pxTask->ulStackDepth);
+        vTaskDelete(xJob);
+        // Cannot fail: the static buffers of this slot were just released
+        (void)prvCreateJobTask(pxTask);
+
+        // Before a new release can start: the new job tracks its resources in the same slot
+        prvReleaseResources(pxTask, xJob);
+        prvTraceJob(TRACE_EVENT_JOB_RECLAIMED, pxTask, xTaskGetTickCount(), ulTimelineStatsJobReclaimed(usIndex));
+
+        // Notifications still deferred were meant for the old task
+        taskENTER_CRITICAL();
+        pxTask->ucKillPending = pdFALSE;
+        pxTask->ucNotifyPending = 0U;
+        xRestart = (pxTask->ucIsActive != pdFALSE) ? pdTRUE : pdFALSE;
+        taskEXIT_CRITICAL();
+
+        if (xRestart != pdFALSE) {
+            // Released again while the old task was waiting to be reaped
+            xTaskNotifyGiveIndexed(pxTask->xHandle, TIMELINE_NOTIFY_INDEX);
+        }
+    }
+}
+
+/**
+ * @brief The reaper task of the tick-driven timeline.
+ *
+ * Starts the first frame, then only wakes up for the work the dispatcher
+ * interrupt cannot do: recreating killed jobs, switching schedules at a frame boundary
+ * and dumping statistics.
+ *
+ * @param pvParameters Unused.
+ */
+static void prvReaperTask(void *pvParameters) {
+    (void)pvParameters;
+
+    vTimelineStatsTagTask(xTaskGetIdleTaskHandle(), TIMELINE_UTIL_IDLE);
+    vTimelineStatsReset();
+    vTimelineArenaClearStats();
+
+    taskENTER_CRITICAL();
+#if (TIMELINE_ONESHOT_TIMER == 0)
+    xDispatchTick = xTaskGetTickCount();
+#endif
+    xFrameEpoch = xTaskGetTickCount();
+    ulDispatchEpoch = prvDispatchNow();
+    prvTickStartFrame();
+    prvTickDispatch();
+    xDispatchRunning = pdTRUE;
+    taskEXIT_CRITICAL();
+    prvFlushNotifications();
+
+    for (;;) {
+        (void)ulTaskNotifyTakeIndexed(TIMELINE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+        prvReapKilledJobs();
+
+        if (xBoundaryPending != pdFALSE) {
+            prvApplyPendingSwitch();
+
+            // Catch up with the ticks that elapsed during the switch
+            taskENTER_CRITICAL();
+            xBoundaryPending = pdFALSE;
+            prvTickStartFrame();
+            prvTickDispatch();
+            taskEXIT_CRITICAL();
+            prvFlushNotifications();
+        }
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_DUMP_PERIOD_FRAMES > 0)
+        if (xDumpPending != pdFALSE) {
+            xDumpPending = pdFALSE;
+            vTimelineStatsDump();
         }
-        vTraceLog(TRACE_EVENT_IDLE_END, "Scheduler", xTaskGetTickCount());
+#endif
     }
 }
 
+#endif /* TIMELINE_TICK_DISPATCH */
+
 // --- Public API Implementation ---
 
 BaseType_t xTimelineSchedulerInit(const TimelineConfig_t *pxTimelineConfig) {
-    if (pxTimelineConfig == NULL || pxTimelineConfig->pxTasks == NULL || pxTimelineConfig->uxNumTasks > MAX_TASKS) {
+    UBaseType_t uxScheduleId;
+
+    // A running timeline must be stopped before it can be replaced
+    if (xSchedulerTaskHandle != NULL) {
+        return pdFAIL;
+    }
+
+    if (xTimelineSchedulerRegister(pxTimelineConfig, &uxScheduleId) != pdPASS) {
         return pdFAIL;
     }
 
-    xSchedulerConfig = *pxTimelineConfig;
-    uxManagedTasksCount = xSchedulerConfig.uxNumTasks;
+    pxActiveJob = NULL;
+    pxActiveSoftJob = NULL;
+    uxNextSoftTask = 0;
+    ulFrameOverrunCount = 0;
+    ulFrameCount = 0;
+    uxPendingSchedule = TIMELINE_NO_PENDING_SWITCH;
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_DUMP_PERIOD_FRAMES > 0)
+    ulFramesSinceDump = 0;
+#endif
 
     // Initialize managed tasks array
     memset(xManagedTasks, 0, sizeof(xManagedTasks));
-    for (UBaseType_t i = 0; i < uxManagedTasksCount; i++) {
-        xManagedTasks[i].pxConfig = &xSchedulerConfig.pxTasks[i];
-        xManagedTasks[i].xHandle = NULL;
-        xManagedTasks[i].xIsActive = pdFALSE;
-    }
-    
+    uxManagedTasksCount = 0;
+
     vTraceInit();
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    // First, as the statistics may use the free-running timer as their cycle counter
+    vTimelineTimerInit();
+#endif
+    vTimelineStatsInit();
+
+    // With the static pool, every managed task is created up front; releases only restart them
+    if (prvActivateSchedule(&xSchedules[uxScheduleId]) != pdPASS) {
+        prvDeleteJobTasks();
+        prvDropSchedules(uxScheduleId);
+        return pdFAIL;
+    }
 
+#if (TIMELINE_TICK_DISPATCH == 1)
+    // The tick hook or the timer does the dispatching; the reaper starts the first frame
+    xDispatchRunning = pdFALSE;
+    xBoundaryPending = pdFALSE;
+    xDumpPending = pdFALSE;
+    xTaskCreate(prvReaperTask,
+                "Reaper",
+                configMINIMAL_STACK_SIZE * 2,
+                NULL,
+                TIMELINE_SCHEDULER_PRIORITY, // Above the jobs so that a killed job never runs again
+                &xSchedulerTaskHandle);
+#else
     // Create the main scheduler task here, so it's ready to run when the scheduler starts
     xTaskCreate(prvSchedulerTask,
                 "Scheduler",
                 configMINIMAL_STACK_SIZE * 2,
                 NULL,
-                tskIDLE_PRIORITY + 1, // High priority, but lower than HRT tasks it spawns
+                TIMELINE_SCHEDULER_PRIORITY, // Above the jobs it spawns so deadlines can always be enforced
                 &xSchedulerTaskHandle);
+#endif
+    if (xSchedulerTaskHandle == NULL) {
+        prvDeleteJobTasks();
+        prvDropSchedules(uxScheduleId);
+        return pdFAIL;
+    }
+    vTimelineStatsTagTask(xSchedulerTaskHandle, TIMELINE_UTIL_SCHEDULER);
+
+    return pdPASS;
+}
+
+BaseType_t xTimelineSchedulerRegister(const TimelineConfig_t *pxTimelineConfig, UBaseType_t *puxScheduleId) {
+    UBaseType_t uxScheduleId = uxScheduleCount;
+
+    if (pxTimelineConfig == NULL || uxScheduleId >= TIMELINE_MAX_SCHEDULES) {
+        return pdFAIL;
+    }
+
+    if (prvCompileSchedule(&xSchedules[uxScheduleId], pxTimelineConfig) != pdPASS) {
+        return pdFAIL;
+    }
+
+    // Published only once compiled, so a concurrent switch request never sees a partial table
+    uxScheduleCount = uxScheduleId + 1;
+    if (puxScheduleId != NULL) {
+        *puxScheduleId = uxScheduleId;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTimelineSchedulerRequestSwitch(UBaseType_t uxScheduleId) {
+    TickType_t xNow;
 
+    if (uxScheduleId >= uxScheduleCount) {
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    xNow = xTaskGetTickCount();
+    uxPendingSchedule = uxScheduleId;
+    xSwitchRequestTick = xNow;
+    taskEXIT_CRITICAL();
+
+    vTraceLog(TRACE_EVENT_SWITCH_REQUEST, TRACE_TASK_ID_SCHEDULER, xNow, uxScheduleId);
+    return pdPASS;
+}
+
+BaseType_t xTimelineSchedulerRequestSwitchFromISR(UBaseType_t uxScheduleId) {
+    UBaseType_t uxSavedInterruptStatus;
+    TickType_t xNow;
+
+    if (uxScheduleId >= uxScheduleCount) {
+        return pdFAIL;
+    }
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    xNow = xTaskGetTickCountFromISR();
+    uxPendingSchedule = uxScheduleId;
+    xSwitchRequestTick = xNow;
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    vTraceLog(TRACE_EVENT_SWITCH_REQUEST, TRACE_TASK_ID_SCHEDULER, xNow, uxScheduleId);
     return pdPASS;
 }
 
+UBaseType_t uxTimelineSchedulerGetActiveSchedule(void) {
+    return (UBaseType_t)(pxActiveSchedule - xSchedules);
+}
+
 void vTimelineSchedulerStart(void) {
     // This function is now primarily for conceptual separation.
     // The scheduler task is created during init and will run automatically.
     // We could add a synchronization mechanism here if we needed to delay
     // the start of the major frame loop, but for now it's not required.
 }
+
+void vTimelineSchedulerStop(void) {
+#if (TIMELINE_TICK_DISPATCH == 1)
+    taskENTER_CRITICAL();
+    xDispatchRunning = pdFALSE;
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    vTimelineTimerDisarm();
+#endif
+    taskEXIT_CRITICAL();
+#endif
+
+    if (xSchedulerTaskHandle != NULL) {
+        vTaskDelete(xSchedulerTaskHandle);
+        xSchedulerTaskHandle = NULL;
+    }
+
+    prvDeleteJobTasks();
+    pxActiveJob = NULL;
+    pxActiveSoftJob = NULL;
+    uxNextSoftTask = 0;
+
+    // Registered schedules and state blocks do not outlive the timeline that used them
+    uxPendingSchedule = TIMELINE_NO_PENDING_SWITCH;
+    prvDropSchedules(0);
+    vTimelineStateClear();
+}
+
+void vTimelineSchedulerTickHook(void) {
+#if (TIMELINE_TICK_DISPATCH == 1) && (TIMELINE_ONESHOT_TIMER == 0)
+    xDispatchTick++;
+    // Anything woken sets xYieldPending, which the tick handler acts upon
+    (void)prvDispatchFromISR();
+#endif
+}
+
+BaseType_t xTimelineSchedulerTimerHook(void) {
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    return prvDispatchFromISR();
+#else
+    return pdFALSE;
+#endif
+}
+
+void vTimelineSchedulerStepTick(TickType_t xTicks) {
+#if (TIMELINE_TICK_DISPATCH == 1) && (TIMELINE_ONESHOT_TIMER == 0)
+    xDispatchTick += xTicks;
+#else
+    (void)xTicks;
+#endif
+}
+
+TickType_t xTimelineSchedulerTicksToNextEvent(void) {
+#if (TIMELINE_TICK_DISPATCH == 1) && (TIMELINE_ONESHOT_TIMER == 0)
+    uint32_t ulNextOffset;
+
+    if (xDispatchRunning == pdFALSE || xBoundaryPending != pdFALSE) {
+        return portMAX_DELAY;
+    }
+
+    ulNextOffset = (uxNextEvent < pxActiveSchedule->uxEventCount) ? pxActiveSchedule->pxEvents[uxNextEvent].ulOffset
+                                                                  : pxActiveSchedule->ulMajorFrameTicks;
+    return (ulDispatchEpoch + ulNextOffset) - xDispatchTick;
+#else
+    return portMAX_DELAY;
+#endif
+}
+
+uint32_t ulTimelineSchedulerGetFrameOverrunCount(void) {
+    return ulFrameOverrunCount;
+}
+
+uint32_t ulTimelineSchedulerGetFrameCount(void) {
+    return ulFrameCount;
+}
+
+BaseType_t xTimelineSchedulerGetTaskCounters(UBaseType_t uxIndex, TimelineTaskCounters_t *pxCounters) {
+    if (uxIndex >= uxManagedTasksCount || pxCounters == NULL) {
+        return pdFAIL;
+    }
+
+    // Updated by the dispatcher interrupt with TIMELINE_TICK_DISPATCH
+    taskENTER_CRITICAL();
+    *pxCounters = xManagedTasks[uxIndex].xCounters;
+    taskEXIT_CRITICAL();
+    return pdPASS;
+}
+
+UBaseType_t uxTimelineSchedulerGetTaskCount(void) {
+    return uxManagedTasksCount;
+}
+
+void vTimelineSchedulerGetMemoryUsage(TimelineMemoryUsage_t *pxUsage) {
+    if (pxUsage == NULL) {
+        return;
+    }
+
+    pxUsage->xTaskSlotBytes = sizeof(ManagedTask_t);
+    pxUsage->xReservedBytes = sizeof(xSchedules) + sizeof(xManagedTasks);
+#if (TIMELINE_MAX_COMPILED_SCHEDULES > 0)
+    pxUsage->xReservedBytes += sizeof(xTableStorage);
+#endif
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    pxUsage->xTaskSlotBytes += sizeof(StaticTask_t);
+    pxUsage->xReservedBytes += sizeof(xJobTaskBuffers) + sizeof(xJobStackArena);
+#endif
+#if (TIMELINE_TICK_DISPATCH == 1)
+    pxUsage->xReservedBytes += sizeof(usKillQueue);
+#endif
+
+    pxUsage->xActiveBytes = uxManagedTasksCount * pxUsage->xTaskSlotBytes;
+    if (pxActiveSchedule == NULL) {
+        return;
+    }
+    // Tables declared with TIMELINE_DEFINE() are in flash
+    if (pxActiveSchedule->xConfig.pxTable == NULL) {
+        pxUsage->xActiveBytes += pxActiveSchedule->uxEventCount * sizeof(TimelineEvent_t) +
+                                 pxActiveSchedule->uxSoftTaskCount * sizeof(uint16_t);
+    }
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1)
+    for (UBaseType_t i = 0; i < uxManagedTasksCount; i++) {
+        pxUsage->xActiveBytes += xManagedTasks[i].ulStackDepth * sizeof(StackType_t);
+    }
+#endif
+}
+
+void vTimelineSchedulerReportStackOverflow(TaskHandle_t xTask, const char *pcTaskName) {
+    char cLine[80];
+
+    ManagedTask_t *pxTask = prvFindJob(xTask);
+
+    if (pxTask != NULL) {
+        snprintf(cLine, sizeof(cLine), "Stack overflow in timeline task %lu (%s, %lu words)\r\n",
+                 (unsigned long)prvTaskIndex(pxTask), pcTaskName, (unsigned long)pxTask->ulStackDepth);
+        // The drain task may never run again, so the record is mainly for trace hooks
+        vTraceLog(TRACE_EVENT_STACK_OVERFLOW, prvTaskIndex(pxTask), xTaskGetTickCountFromISR(), 0);
+        UART_printf(cLine);
+        return;
+    }
+
+    snprintf(cLine, sizeof(cLine), "Stack overflow in task %s\r\n", pcTaskName);
+    UART_printf(cLine);
+}
+
+const TimelineTaskConfig_t *pxTimelineSchedulerGetTaskConfig(UBaseType_t uxIndex) {
+    if (uxIndex >= uxManagedTasksCount) {
+        return NULL;
+    }
+    return xManagedTasks[uxIndex].pxConfig;
+}
+
+BaseType_t xTimelineJobAbortRequested(void) {
+    ManagedTask_t *pxTask = prvCurrentJob();
+
+    return (pxTask != NULL) ? pxTask->ucAbortRequested : pdFALSE;
+}
+
+BaseType_t xTimelineJobTrackResource(TimelineReleaseFunction_t pvRelease, void *pvResource) {
+    ManagedTask_t *pxTask = prvCurrentJob();
+    BaseType_t xResult = pdPASS;
+
+    if (pvRelease == NULL) {
+        return pdFAIL;
+    }
+    if (pxTask == NULL) {
+        return pdPASS;
+    }
+
+    taskENTER_CRITICAL();
+    if (pxTask->ucResourceCount < TIMELINE_MAX_JOB_RESOURCES) {
+        pxTask->xResources[pxTask->ucResourceCount].pvRelease = pvRelease;
+        pxTask->xResources[pxTask->ucResourceCount].pvResource = pvResource;
+        pxTask->ucResourceCount++;
+    } else {
+        xResult = pdFAIL;
+    }
+    taskEXIT_CRITICAL();
+
+    return xResult;
+}
+
+void vTimelineJobUntrackResource(void *pvResource) {
+    ManagedTask_t *pxTask = prvCurrentJob();
+
+    if (pxTask == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    for (UBaseType_t i = pxTask->ucResourceCount; i > 0; i--) {
+        if (pxTask->xResources[i - 1].pvResource == pvResource) {
+            // The others keep their order, which is the order they are released in
+            memmove(&pxTask->xResources[i - 1], &pxTask->xResources[i],
+                    (pxTask->ucResourceCount - i) * sizeof(JobResource_t));
+            pxTask->ucResourceCount--;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
@@ -20,39 +20,394 @@
  */
 #define MAJOR_FRAME_DURATION_TICKS pdMS_TO_TICKS(100)
 
+/**
+ * @brief Defines the duration of a sub-frame in ticks.
+ * Sub-frame N spans [N * SUBFRAME_DURATION_TICKS, (N + 1) * SUBFRAME_DURATION_TICKS)
+ * from the beginning of the major frame.
+ */
+#define SUBFRAME_DURATION_TICKS pdMS_TO_TICKS(50)
+
+/**
+ * @brief Number of sub-frames in a major frame.
+ */
+#define SUBFRAMES_PER_MAJOR_FRAME (MAJOR_FRAME_DURATION_TICKS / SUBFRAME_DURATION_TICKS)
+
 /**
  * @brief Maximum number of tasks the scheduler can manage.
+ *
+ * Sizes the static task slots, and with them the statistics and trace name
+ * tables. The cost of an event and of a frame boundary does not depend on it,
+ * nor on the number of tasks in the active schedule: events index their task
+ * directly, a job finds its own slot from its task handle, and the reaper
+ * only visits the jobs that were killed. Walks over every task are left to
+ * registration, schedule activation and statistics dumps.
  */
+#ifndef MAX_TASKS
 #define MAX_TASKS 16
+#endif
+
+#if (MAX_TASKS < 1) || (MAX_TASKS >= 0xFFFF)
+#error "MAX_TASKS must be between 1 and 65534: task indices are 16-bit and 0xFFFF is the scheduler's trace id"
+#endif
+
+/**
+ * @brief Maximum number of schedules that can be registered at the same time.
+ *
+ * Each registered schedule keeps its own precompiled event table, so that a
+ * mode change only swaps tables at the frame boundary.
+ */
+#ifndef TIMELINE_MAX_SCHEDULES
+#define TIMELINE_MAX_SCHEDULES 4
+#endif
+
+/**
+ * @brief Maximum number of schedules whose event tables are compiled at run time.
+ *
+ * Schedules declared with TIMELINE_DEFINE() (see timeline_table.h) bring
+ * their table in flash and take none of these slots, so a build whose
+ * schedules are all declared that way can set this to 0 and drop the
+ * table storage from RAM.
+ */
+#ifndef TIMELINE_MAX_COMPILED_SCHEDULES
+#define TIMELINE_MAX_COMPILED_SCHEDULES TIMELINE_MAX_SCHEDULES
+#endif
+
+/**
+ * @brief Maximum number of sub-frames in the major frame of any schedule.
+ *
+ * Schedules may use their own frame layout (see TimelineConfig_t); this bounds
+ * the size of the event tables and of the per-sub-frame statistics.
+ */
+#ifndef TIMELINE_MAX_SUBFRAMES
+#define TIMELINE_MAX_SUBFRAMES SUBFRAMES_PER_MAJOR_FRAME
+#endif
+
+/**
+ * @brief Maximum number of entries in an event table compiled at run time.
+ *
+ * An HRT task takes a release, a deadline and an abort request per instance,
+ * and a sub-frame takes one start, so the default fits MAX_TASKS tasks
+ * released once per frame. Raise it for schedules with multi-rate tasks (see
+ * ulPeriodTicks): their releases cost 8 bytes of table each, but no task slot,
+ * stack or trace name. A schedule whose table does not fit is rejected at
+ * registration.
+ */
+#ifndef TIMELINE_MAX_EVENTS
+#define TIMELINE_MAX_EVENTS ((3 * MAX_TASKS) + TIMELINE_MAX_SUBFRAMES)
+#endif
+
+/**
+ * @brief Set to 1 to run managed jobs from a pool of statically allocated tasks.
+ *
+ * Every managed task is then created once, at xTimelineSchedulerInit(), with a
+ * static TCB and stack. A release restarts the pre-created task with a single
+ * notification instead of calling xTaskCreate(), and a killed job is recreated
+ * in the same buffers, as are the tasks rebound by a schedule switch, so no
+ * heap memory is used after init. Set to 0 to create
+ * and delete a task on every release instead.
+ * Requires configSUPPORT_STATIC_ALLOCATION to be set to 1.
+ */
+#ifndef TIMELINE_USE_STATIC_TASK_POOL
+#define TIMELINE_USE_STATIC_TASK_POOL 1
+#endif
+
+/**
+ * @brief Default stack depth, in words, of a managed task.
+ *
+ * Used for tasks whose ulStackDepth is 0.
+ */
+#ifndef TIMELINE_TASK_STACK_DEPTH
+#define TIMELINE_TASK_STACK_DEPTH configMINIMAL_STACK_SIZE
+#endif
+
+/**
+ * @brief Size, in words, of the static arena the pooled task stacks are carved from.
+ *
+ * Each task of the active schedule takes its own stack depth from the arena,
+ * so a few large stacks can be paid for with many small ones. A schedule whose
+ * stacks do not fit is rejected at registration. The default holds MAX_TASKS
+ * stacks of TIMELINE_TASK_STACK_DEPTH words.
+ */
+#ifndef TIMELINE_STACK_ARENA_WORDS
+#define TIMELINE_STACK_ARENA_WORDS (MAX_TASKS * TIMELINE_TASK_STACK_DEPTH)
+#endif
+
+#if (TIMELINE_USE_STATIC_TASK_POOL == 1) && (configSUPPORT_STATIC_ALLOCATION != 1)
+#error "TIMELINE_USE_STATIC_TASK_POOL requires configSUPPORT_STATIC_ALLOCATION to be set to 1"
+#endif
+
+/**
+ * @brief Set to 1 to dispatch the timeline from the kernel tick instead of a scheduler task.
+ *
+ * The event table is then walked by vTimelineSchedulerTickHook(), called from
+ * vApplicationTickHook() inside the tick interrupt. Releases notify the pooled
+ * job directly from the interrupt, so a release costs a single context switch
+ * into the job, and there is no scheduler task waking up for every event.
+ * Work that the kernel does not allow in an interrupt (deleting and
+ * recreating a killed job, applying a schedule switch, dumping statistics) is
+ * deferred to a small reaper task at TIMELINE_SCHEDULER_PRIORITY, which runs
+ * as soon as the interrupt returns, before any job. Requires the static task
+ * pool and configUSE_TICK_HOOK.
+ */
+#ifndef TIMELINE_TICK_DISPATCH
+#define TIMELINE_TICK_DISPATCH 0
+#endif
+
+#if (TIMELINE_TICK_DISPATCH == 1) && (TIMELINE_USE_STATIC_TASK_POOL != 1)
+#error "TIMELINE_TICK_DISPATCH requires TIMELINE_USE_STATIC_TASK_POOL to be set to 1"
+#endif
+
+#if (TIMELINE_TICK_DISPATCH == 1) && (configUSE_TICK_HOOK != 1)
+#error "TIMELINE_TICK_DISPATCH requires configUSE_TICK_HOOK to be set to 1"
+#endif
+
+/**
+ * @brief Set to 1 to dispatch the timeline from a one-shot hardware timer.
+ *
+ * A refinement of TIMELINE_TICK_DISPATCH: instead of inspecting the table at
+ * every tick, the dispatcher arms CMSDK Timer0 for the exact instant of the
+ * next event and runs in its interrupt (see timeline_timer.h). Windows given
+ * in microseconds (ulStartTimeUs, ulEndTimeUs) are then kept to the timer's
+ * resolution rather than rounded to ticks, and no timeline interrupt occurs
+ * while nothing is due. The frame layout stays in ticks. Combine with
+ * configUSE_TICKLESS_IDLE, which FreeRTOSConfig.h enables together with this
+ * option, to stop the SysTick during idle gaps too. Target builds only.
+ */
+#ifndef TIMELINE_ONESHOT_TIMER
+#define TIMELINE_ONESHOT_TIMER 0
+#endif
+
+/**
+ * @brief Input clock of the CMSDK timers, in Hz. On the MPS2 it is the CPU clock.
+ */
+#ifndef TIMELINE_TIMER_HZ
+#define TIMELINE_TIMER_HZ configCPU_CLOCK_HZ
+#endif
+
+/**
+ * @brief Units of the event table offsets per tick.
+ *
+ * The offsets are kept in timer cycles with the one-shot timer, so that
+ * microsecond windows keep their precision, and in ticks otherwise.
+ */
+#if (TIMELINE_ONESHOT_TIMER == 1)
+#define TIMELINE_UNITS_PER_TICK (TIMELINE_TIMER_HZ / configTICK_RATE_HZ)
+#else
+#define TIMELINE_UNITS_PER_TICK 1UL
+#endif
+
+#if (TIMELINE_ONESHOT_TIMER == 1) && (TIMELINE_TICK_DISPATCH != 1)
+#error "TIMELINE_ONESHOT_TIMER requires TIMELINE_TICK_DISPATCH to be set to 1"
+#endif
+
+#if (TIMELINE_ONESHOT_TIMER == 1) && defined(TIMELINE_SIM)
+#error "TIMELINE_ONESHOT_TIMER needs the CMSDK timers and is not available in the host simulation"
+#endif
+
+/**
+ * @brief Set to 1 to have HRT tasks with the TIMELINE_MISS_ESCALATE policy
+ * report their deadline misses to vApplicationTimelineDeadlineHook().
+ *
+ * The application must then provide the hook, as it does for the kernel's
+ * own hooks. Schedules using TIMELINE_MISS_ESCALATE are rejected when it is 0.
+ */
+#ifndef TIMELINE_USE_DEADLINE_HOOK
+#define TIMELINE_USE_DEADLINE_HOOK 0
+#endif
+
+/**
+ * @brief Ticks before its deadline at which a running HRT job is asked to stop.
+ *
+ * The scheduler then sets the flag read by xTimelineJobAbortRequested() and
+ * gives the notification at TIMELINE_ABORT_NOTIFY_INDEX, so that a job can
+ * unwind and return by itself. A job that is still running at its deadline is
+ * terminated as before. Windows no longer than the lead get no request. Set
+ * to 0 to disable abort requests.
+ */
+#ifndef TIMELINE_ABORT_LEAD_TICKS
+#define TIMELINE_ABORT_LEAD_TICKS 2
+#endif
+
+/**
+ * @brief Task notification index on which abort requests are given to jobs.
+ *
+ * Index 0 is left to the application and index 1 is used by the scheduler.
+ */
+#define TIMELINE_ABORT_NOTIFY_INDEX 2
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES <= TIMELINE_ABORT_NOTIFY_INDEX)
+#error "configTASK_NOTIFICATION_ARRAY_ENTRIES is too small for TIMELINE_ABORT_NOTIFY_INDEX"
+#endif
+
+/**
+ * @brief Maximum number of resources a job can track at the same time.
+ *
+ * See xTimelineJobTrackResource(). Every task slot reserves this many entries
+ * of two pointers, so timelines of hundreds of tasks should keep it low.
+ */
+#ifndef TIMELINE_MAX_JOB_RESOURCES
+#define TIMELINE_MAX_JOB_RESOURCES 4
+#endif
+
+#if (TIMELINE_MAX_JOB_RESOURCES > 255)
+#error "TIMELINE_MAX_JOB_RESOURCES must be at most 255"
+#endif
+
+/**
+ * @brief Priority of the scheduler control task, or of the reaper task with
+ * TIMELINE_TICK_DISPATCH.
+ *
+ * The scheduler must run above every job it spawns so that it can preempt a
+ * running job at its deadline and react to completions on the same tick.
+ */
+#define TIMELINE_SCHEDULER_PRIORITY (configMAX_PRIORITIES - 1)
+
+/**
+ * @brief Priority at which HRT jobs are executed.
+ */
+#define TIMELINE_HRT_PRIORITY (tskIDLE_PRIORITY + 2)
+
+/**
+ * @brief Priority at which SRT jobs are executed.
+ *
+ * Kept below TIMELINE_HRT_PRIORITY so that an HRT release preempts the running
+ * SRT job at once and the SRT job resumes where it stopped afterwards.
+ */
+#define TIMELINE_SRT_PRIORITY (tskIDLE_PRIORITY + 1)
 
 /**
  * @brief Defines the type of a task.
  */
 typedef enum {
     TASK_TYPE_HARD_RT, /**< Hard Real-Time: runs at a fixed time, non-preemptible by other tasks. */
-    TASK_TYPE_SOFT_RT  /**< Soft Real-Time: runs in idle time, preemptible by HRT tasks. */
+    TASK_TYPE_SOFT_RT  /**< Soft Real-Time: runs in idle time in declaration order, preemptible by HRT tasks. */
 } TaskType_t;
 
+/**
+ * @brief What the scheduler does after terminating an HRT job at its deadline.
+ *
+ * The job is always terminated and reported with TRACE_EVENT_DEADLINE_MISS;
+ * the policy decides what happens to the following releases. SRT tasks have
+ * no deadline and ignore it.
+ */
+typedef enum {
+    TIMELINE_MISS_KILL = 0,  /**< Nothing more: the next release runs as usual. */
+    TIMELINE_MISS_SKIP,      /**< Skip the next ulMissSkipReleases releases (at least one). */
+    TIMELINE_MISS_DEGRADE,   /**< Run pvDegradedCode instead of the task function until a job completes. */
+    TIMELINE_MISS_ESCALATE   /**< Call vApplicationTimelineDeadlineHook(). Requires TIMELINE_USE_DEADLINE_HOOK. */
+} TimelineMissPolicy_t;
+
 /**
  * @brief Configuration structure for a single task in the timeline.
+ *
+ * An HRT window is given either in ticks or, when ulEndTimeUs is set, in
+ * microseconds. Microsecond windows keep their precision with
+ * TIMELINE_ONESHOT_TIMER; otherwise they must fall on tick edges.
+ *
+ * An HRT task with ulPeriodTicks set is multi-rate: its window is that of
+ * the first instance, offset from the start of the frame, and is repeated
+ * every ulPeriodTicks across the major frame. Each instance is a release of
+ * its own, with its own deadline and miss handling, and is traced with its
+ * instance number, but all of them share one task slot, one stack and one
+ * name. The period must divide the major frame into at most 255 instances,
+ * the window must end within the first period, and every instance must lie
+ * inside one sub-frame, which ulSubframeId does not name for these tasks.
  */
 typedef struct {
-    TaskFunction_t pvTaskCode;      /**< Pointer to the task's function. */
+    TaskFunction_t pvTaskCode;      /**< Pointer to the task's function. It runs from start to end and returns on completion. */
     const char *pcName;             /**< A descriptive name for the task. */
     TaskType_t xTaskType;           /**< The type of the task (HARD_RT or SOFT_RT). */
     uint32_t ulStartTimeTicks;      /**< Start time in ticks from the beginning of the major frame (for HRT tasks). */
     uint32_t ulEndTimeTicks;        /**< Deadline in ticks from the beginning of the major frame (for HRT tasks). */
-    uint32_t ulSubframeId;          /**< ID of the sub-frame this task belongs to (for HRT tasks, informational). */
+    uint32_t ulSubframeId;          /**< ID of the sub-frame this task belongs to (for HRT tasks). The window must lie inside it. */
+    uint32_t ulStackDepth;          /**< Stack depth in words, 0 for TIMELINE_TASK_STACK_DEPTH. Raised to configMINIMAL_STACK_SIZE if smaller. */
+    uint32_t ulStartTimeUs;         /**< Start time in microseconds, used instead of ulStartTimeTicks when ulEndTimeUs is not 0. */
+    uint32_t ulEndTimeUs;           /**< Deadline in microseconds, or 0 to use the tick fields. */
+    TimelineMissPolicy_t xMissPolicy; /**< Reaction to a deadline miss (for HRT tasks). */
+    uint32_t ulMissSkipReleases;    /**< Releases skipped after a miss with TIMELINE_MISS_SKIP, 0 for one. */
+    TaskFunction_t pvDegradedCode;  /**< Alternate handler for TIMELINE_MISS_DEGRADE, NULL otherwise. */
+    uint32_t ulPeriodTicks;         /**< Release period of a multi-rate HRT task, or 0 for one release per major frame. */
 } TimelineTaskConfig_t;
 
+/**
+ * @brief Runtime counters of a managed task, see xTimelineSchedulerGetTaskCounters().
+ */
+typedef struct {
+    uint32_t ulMisses;       /**< Jobs terminated at their deadline. */
+    uint32_t ulOverruns;     /**< Releases that could not start on time and were skipped. */
+    uint32_t ulPolicySkips;  /**< Releases skipped by TIMELINE_MISS_SKIP. */
+    uint32_t ulDegradedRuns; /**< Jobs that ran the degraded handler. */
+} TimelineTaskCounters_t;
+
+/**
+ * @brief RAM taken by the scheduler, see vTimelineSchedulerGetMemoryUsage().
+ */
+typedef struct {
+    size_t xTaskSlotBytes;  /**< Bookkeeping of one task slot, its TCB buffer included with the static pool. */
+    size_t xReservedBytes;  /**< All static state: MAX_TASKS slots, schedules, compiled tables and stack arena. */
+    size_t xActiveBytes;    /**< Part of it used by the active schedule: its slots, pooled stacks and RAM event table. */
+} TimelineMemoryUsage_t;
+
+/**
+ * @brief Function that releases a resource held by a job, see xTimelineJobTrackResource().
+ *
+ * @param pvResource The resource, as passed when it was tracked.
+ * @param xJob Handle of the job's task. When the job was terminated the task
+ * has already been deleted: the handle may only be compared, never used.
+ */
+typedef void (*TimelineReleaseFunction_t)(void *pvResource, TaskHandle_t xJob);
+
+/**
+ * @brief Kinds of entries in a compiled event table.
+ *
+ * The numeric order is the processing order of events that fall on the same
+ * tick: a job whose deadline coincides with a boundary is terminated before
+ * the next sub-frame begins and before anything new is released.
+ */
+typedef enum {
+    TIMELINE_EVENT_DEADLINE = 0, /**< End of an HRT window. */
+    TIMELINE_EVENT_SUBFRAME,     /**< Start of a sub-frame. */
+    TIMELINE_EVENT_RELEASE,      /**< Start of an HRT window. */
+    TIMELINE_EVENT_ABORT,        /**< Abort request, TIMELINE_ABORT_LEAD_TICKS before the end of an HRT window. */
+    TIMELINE_EVENT_NONE          /**< Placeholder for an abort request a window is too short for; ignored. */
+} TimelineEventKind_t;
+
+/**
+ * @brief One entry of a compiled, time-sorted event table.
+ */
+typedef struct {
+    uint32_t ulOffset;      /**< Offset of the event from the start of the major frame, see TIMELINE_UNITS_PER_TICK. */
+    uint16_t usIndex;       /**< Managed task index, or sub-frame id for TIMELINE_EVENT_SUBFRAME. */
+    uint8_t ucKind;         /**< One of TimelineEventKind_t. */
+    uint8_t ucInstance;     /**< Instance of a multi-rate task the event belongs to, 0 otherwise. */
+} TimelineEvent_t;
+
+/**
+ * @brief Dispatch table of a schedule, compiled at build time by TIMELINE_DEFINE().
+ *
+ * Entries are sorted by offset, then by kind, as the scheduler would have
+ * sorted them at registration.
+ */
+typedef struct {
+    const TimelineEvent_t *pxEvents;  /**< Release, deadline, abort and sub-frame events, sorted by time. */
+    uint16_t usEventCount;
+    const uint16_t *pusSoftTaskOrder; /**< Managed task indices of the SRT tasks, in declaration order. */
+    uint16_t usSoftTaskCount;
+} TimelineTable_t;
+
 /**
  * @brief Main configuration structure for the timeline scheduler.
  *
  * This structure holds the array of task configurations and the total number of tasks.
+ * The frame layout defaults to MAJOR_FRAME_DURATION_TICKS and SUBFRAME_DURATION_TICKS
+ * when the corresponding fields are left at 0.
  */
 typedef struct {
     const TimelineTaskConfig_t *pxTasks; /**< Array of task configurations. */
     UBaseType_t uxNumTasks;              /**< Number of tasks in the array. */
+    uint32_t ulMajorFrameTicks;          /**< Length of the major frame in ticks, or 0 for the default. */
+    uint32_t ulSubframeTicks;            /**< Length of a sub-frame in ticks, or 0 for the default. Must divide the major frame. */
+    const TimelineTable_t *pxTable;      /**< Table compiled at build time by TIMELINE_DEFINE(), or NULL to compile it at registration. */
 } TimelineConfig_t;
 
 
@@ -61,11 +416,19 @@ typedef struct {
 /**
  * @brief Initializes and starts the timeline-based scheduler.
  *
- * This function configures the scheduler based on the provided timeline definition,
- * creates the necessary internal data structures, and starts the scheduler's control task.
+ * This function registers the provided timeline definition as a schedule (see
+ * xTimelineSchedulerRegister()), makes it the active one and creates the
+ * scheduler's control task. Tasks may be declared in any order.
  *
  * @param pxTimelineConfig Pointer to the main timeline configuration structure.
- * @return pdPASS if initialization was successful, pdFAIL otherwise.
+ * @return pdPASS if initialization was successful, pdFAIL if the configuration
+ * is invalid (too many tasks, a frame layout that does not fit, or an HRT
+ * window that is empty, ends after the major frame or does not lie inside its
+ * sub-frame, a microsecond window off the tick grid without
+ * TIMELINE_ONESHOT_TIMER, a miss policy that is unknown or lacks its handler
+ * or hook, a release period that does not fit the frame, or more events than
+ * TIMELINE_MAX_EVENTS), no schedule slot is left or a timeline is already
+ * running.
  */
 BaseType_t xTimelineSchedulerInit(const TimelineConfig_t *pxTimelineConfig);
 
@@ -77,4 +440,238 @@ BaseType_t xTimelineSchedulerInit(const TimelineConfig_t *pxTimelineConfig);
  */
 void vTimelineSchedulerStart(void);
 
+/**
+ * @brief Stops the running timeline and deletes the scheduler and job tasks.
+ *
+ * All registered schedules are dropped. Afterwards xTimelineSchedulerInit()
+ * can be called again, with the same or another configuration; the trace and
+ * statistics layers stay in place. Must
+ * be called from a task that runs below TIMELINE_SCHEDULER_PRIORITY and is
+ * not one of the managed jobs.
+ */
+void vTimelineSchedulerStop(void);
+
+/**
+ * @brief Precompiles a schedule so that it can be switched to later.
+ *
+ * The configuration is validated and compiled into its own event table, as
+ * xTimelineSchedulerInit() does for the initial one. Schedules may be
+ * registered before init or while the timeline runs, from one task at a time;
+ * the task array must stay valid until vTimelineSchedulerStop().
+ *
+ * A configuration declared with TIMELINE_DEFINE() already carries its table,
+ * checked by the compiler; it is used in place, and only what the compiler
+ * cannot see (the miss policy handlers and the stack arena) is checked here.
+ *
+ * @param pxTimelineConfig The schedule to register.
+ * @param puxScheduleId Receives the id to pass to xTimelineSchedulerRequestSwitch(). May be NULL.
+ * @return pdPASS on success, pdFAIL if the configuration is invalid, its task
+ * stacks do not fit in TIMELINE_STACK_ARENA_WORDS, all TIMELINE_MAX_SCHEDULES
+ * slots are in use or, for a configuration without a table, all
+ * TIMELINE_MAX_COMPILED_SCHEDULES tables are.
+ */
+BaseType_t xTimelineSchedulerRegister(const TimelineConfig_t *pxTimelineConfig, UBaseType_t *puxScheduleId);
+
+/**
+ * @brief Requests a switch to another registered schedule.
+ *
+ * The switch takes effect at the next major frame boundary, after every job of
+ * the current frame has been reclaimed, so no release of either schedule is
+ * dropped. It swaps precompiled tables and recreates the pooled job tasks in
+ * their static buffers; no memory is allocated. A later request made before
+ * the boundary replaces an earlier one. The request and the switch are traced
+ * as TRACE_EVENT_SWITCH_REQUEST and TRACE_EVENT_SCHEDULE_SWITCH, the latter
+ * with the number of ticks elapsed since the request.
+ *
+ * @param uxScheduleId Id returned by xTimelineSchedulerRegister().
+ * @return pdPASS if the request was recorded, pdFAIL if the id is unknown.
+ */
+BaseType_t xTimelineSchedulerRequestSwitch(UBaseType_t uxScheduleId);
+
+/**
+ * @brief Version of xTimelineSchedulerRequestSwitch() callable from an ISR.
+ */
+BaseType_t xTimelineSchedulerRequestSwitchFromISR(UBaseType_t uxScheduleId);
+
+/**
+ * @brief Returns the id of the schedule the timeline is running.
+ */
+UBaseType_t uxTimelineSchedulerGetActiveSchedule(void);
+
+/**
+ * @brief Advances the tick-driven timeline by one tick.
+ *
+ * Must be called from vApplicationTickHook(). With TIMELINE_TICK_DISPATCH it
+ * processes every timeline event that has become due; otherwise, and with
+ * TIMELINE_ONESHOT_TIMER, it does nothing, so the hook can be installed
+ * unconditionally.
+ */
+void vTimelineSchedulerTickHook(void);
+
+/**
+ * @brief Processes the timeline events that are due at a one-shot timer expiry.
+ *
+ * Called by TIMER0_Handler() with TIMELINE_ONESHOT_TIMER; it re-arms the
+ * timer for the next event.
+ *
+ * @return pdTRUE if a task of higher priority than the interrupted one was
+ * released, for portYIELD_FROM_ISR().
+ */
+BaseType_t xTimelineSchedulerTimerHook(void);
+
+/**
+ * @brief Accounts for ticks the kernel skipped with vTaskStepTick().
+ *
+ * For tickless idle implementations: the tick hook is not called for stepped
+ * ticks, so the tick-driven timeline must be told about them. Never step past
+ * xTimelineSchedulerTicksToNextEvent() - 1 ticks.
+ *
+ * @param xTicks Number of ticks passed to vTaskStepTick().
+ */
+void vTimelineSchedulerStepTick(TickType_t xTicks);
+
+/**
+ * @brief Returns the number of ticks until the next timeline event.
+ *
+ * Only meaningful with TIMELINE_TICK_DISPATCH, where the kernel cannot see
+ * the timeline's wake-up times; returns portMAX_DELAY otherwise, with
+ * TIMELINE_ONESHOT_TIMER, whose interrupt wakes the core by itself, or while
+ * no timeline runs. Callable with the scheduler suspended.
+ */
+TickType_t xTimelineSchedulerTicksToNextEvent(void);
+
+/**
+ * @brief Returns how many major frames have started late.
+ *
+ * Frame boundaries are fixed multiples of the active schedule's major frame
+ * from the first frame. A frame whose predecessor ran past this boundary is counted
+ * here and reported with a TRACE_EVENT_FRAME_OVERRUN trace event.
+ *
+ * @return The number of frame overruns since the scheduler started.
+ */
+uint32_t ulTimelineSchedulerGetFrameOverrunCount(void);
+
+/**
+ * @brief Returns the number of major frames started since the scheduler was initialised.
+ *
+ * Incremented at every MAJOR_FRAME_START; frames skipped after an overrun
+ * are not counted. Safe to call from tasks and ISRs.
+ */
+uint32_t ulTimelineSchedulerGetFrameCount(void);
+
+/**
+ * @brief Reads the runtime counters of a managed task.
+ *
+ * A release is counted as an overrun, skipped and traced as
+ * TRACE_EVENT_RELEASE_SKIPPED, when the previous HRT job still owns the CPU,
+ * when the scheduler reaches it only after its window has closed, or when its
+ * task cannot be created. The counters are cleared by
+ * xTimelineSchedulerInit() and stay readable after vTimelineSchedulerStop().
+ *
+ * @param uxIndex Managed task index, in declaration order.
+ * @param pxCounters Receives the counters.
+ * @return pdPASS, or pdFAIL if the index is out of range or pxCounters is NULL.
+ */
+BaseType_t xTimelineSchedulerGetTaskCounters(UBaseType_t uxIndex, TimelineTaskCounters_t *pxCounters);
+
+/**
+ * @brief Returns the number of managed tasks in the active configuration.
+ */
+UBaseType_t uxTimelineSchedulerGetTaskCount(void);
+
+/**
+ * @brief Reports how much RAM the scheduler reserves and how much the active schedule uses.
+ *
+ * Only the scheduler's own state is counted. The statistics and the trace
+ * name table hold one entry per MAX_TASKS slot as well, and without the
+ * static pool each job's TCB and stack come from the heap at every release.
+ *
+ * @param pxUsage Receives the figures.
+ */
+void vTimelineSchedulerGetMemoryUsage(TimelineMemoryUsage_t *pxUsage);
+
+/**
+ * @brief Reports a stack overflow detected by the kernel.
+ *
+ * To be called from vApplicationStackOverflowHook() when
+ * configCHECK_FOR_STACK_OVERFLOW is enabled. Writes the name of the offending
+ * task, and its managed task index if it is a timeline job, synchronously to
+ * the UART and logs a TRACE_EVENT_STACK_OVERFLOW record. The caller decides
+ * how to stop, as the task's stack can no longer be trusted.
+ *
+ * @param xTask Handle of the task whose stack overflowed.
+ * @param pcTaskName Name of that task, as passed to the kernel hook.
+ */
+void vTimelineSchedulerReportStackOverflow(TaskHandle_t xTask, const char *pcTaskName);
+
+/**
+ * @brief Returns the configuration of a managed task.
+ *
+ * @param uxIndex Managed task index, in declaration order.
+ * @return The task configuration, or NULL if the index is out of range.
+ */
+const TimelineTaskConfig_t *pxTimelineSchedulerGetTaskConfig(UBaseType_t uxIndex);
+
+// --- Job API ---
+// Called by the task functions of managed jobs.
+
+/**
+ * @brief Returns whether the scheduler has asked the calling job to stop.
+ *
+ * The request is made TIMELINE_ABORT_LEAD_TICKS before the deadline of an
+ * HRT job that is still running. A job that returns once asked is traced with
+ * TRACE_EVENT_JOB_ABORTED instead of TRACE_EVENT_TASK_COMPLETE, and is not
+ * terminated. Jobs that wait for something can block on
+ * TIMELINE_ABORT_NOTIFY_INDEX with ulTaskNotifyTakeIndexed() to be woken by
+ * the request.
+ *
+ * @return pdTRUE if the job should unwind and return, pdFALSE otherwise or if
+ * the caller is not a managed job.
+ */
+BaseType_t xTimelineJobAbortRequested(void);
+
+/**
+ * @brief Records a resource held by the calling job.
+ *
+ * If the job is terminated before it untracks the resource, the scheduler
+ * calls pvRelease from its own task context once the job's task is deleted,
+ * so that a mutex or a peripheral is never left locked by a dead job.
+ * Resources still tracked when a job returns are released as it returns.
+ * Resources are released in the reverse order of tracking. Safe to call in a
+ * critical section.
+ *
+ * @param pvRelease Function that releases the resource. Must not block, and
+ * must do nothing if the job no longer holds the resource: a job terminated
+ * while its resources are released on return sees the last release repeated.
+ * @param pvResource The resource, passed back to pvRelease.
+ * @return pdPASS, also when the caller is not a managed job (nothing is then
+ * tracked), or pdFAIL if the job already tracks TIMELINE_MAX_JOB_RESOURCES
+ * resources.
+ */
+BaseType_t xTimelineJobTrackResource(TimelineReleaseFunction_t pvRelease, void *pvResource);
+
+/**
+ * @brief Forgets the most recently tracked entry of a resource, once the job released it itself.
+ *
+ * Does nothing if the caller is not a managed job or does not track the resource.
+ * Safe to call in a critical section.
+ */
+void vTimelineJobUntrackResource(void *pvResource);
+
+#if (TIMELINE_USE_DEADLINE_HOOK == 1)
+/**
+ * @brief Application hook called after a TIMELINE_MISS_ESCALATE task missed its deadline.
+ *
+ * Provided by the application when TIMELINE_USE_DEADLINE_HOOK is set. The job
+ * has already been terminated. Called from the scheduler task, or from the
+ * dispatcher interrupt with TIMELINE_TICK_DISPATCH, so it must not block and
+ * may only use interrupt-safe API functions in that mode. It may request a
+ * schedule switch, for example to a degraded mode of the whole system.
+ *
+ * @param uxTaskIndex Managed task index of the job.
+ * @param pcTaskName Name of the task.
+ */
+void vApplicationTimelineDeadlineHook(UBaseType_t uxTaskIndex, const char *pcTaskName);
+#endif
+
 #endif // TIMELINE_SCHEDULER_H
@@ -0,0 +1,70 @@
+/**
+ * @file timeline_state.c
+ * @brief Implementation of the frame-reset state blocks.
+ *
+ * The registry is a flat table walked once per frame; each block is restored
+ * with a single memcpy() or memset(), so the pass costs one call per block
+ * plus a copy proportional to the registered size.
+ */
+
+#include "timeline_state.h"
+#include <string.h>
+
+// --- Private Data Structures ---
+
+/**
+ * @brief A registered state block.
+ */
+typedef struct {
+    void *pvBlock;
+    const void *pvImage;  /**< Initial image, or NULL for a block cleared to zero. */
+    size_t xSize;
+} StateBlock_t;
+
+// --- Private State ---
+
+static StateBlock_t xStateBlocks[TIMELINE_MAX_STATE_BLOCKS];
+static volatile UBaseType_t uxStateBlockCount = 0;
+
+// --- Public API Implementation ---
+
+BaseType_t xTimelineStateRegister(void *pvBlock, const void *pvImage, size_t xSize) {
+    UBaseType_t uxIndex = uxStateBlockCount;
+
+    if (pvBlock == NULL || xSize == 0 || uxIndex >= TIMELINE_MAX_STATE_BLOCKS) {
+        return pdFAIL;
+    }
+
+    xStateBlocks[uxIndex].pvBlock = pvBlock;
+    xStateBlocks[uxIndex].pvImage = pvImage;
+    xStateBlocks[uxIndex].xSize = xSize;
+
+    // Published only once filled in, as the restore may run in the dispatcher interrupt
+    uxStateBlockCount = uxIndex + 1;
+    return pdPASS;
+}
+
+size_t xTimelineStateRestore(void) {
+    UBaseType_t uxCount = uxStateBlockCount;
+    size_t xBytes = 0;
+
+    for (UBaseType_t i = 0; i < uxCount; i++) {
+        const StateBlock_t *pxBlock = &xStateBlocks[i];
+
+        if (pxBlock->pvImage != NULL) {
+            memcpy(pxBlock->pvBlock, pxBlock->pvImage, pxBlock->xSize);
+        } else {
+            memset(pxBlock->pvBlock, 0, pxBlock->xSize);
+        }
+        xBytes += pxBlock->xSize;
+    }
+    return xBytes;
+}
+
+UBaseType_t uxTimelineStateGetCount(void) {
+    return uxStateBlockCount;
+}
+
+void vTimelineStateClear(void) {
+    uxStateBlockCount = 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file timeline_state.h
+ * @brief Application state restored at every major frame.
+ *
+ * Every major frame must start from the same state. Pooled job tasks are
+ * only recreated after a kill, so state a task keeps in static variables
+ * would otherwise carry over from one frame to the next. A task can
+ * instead keep such state in a registered block: at the start of every major
+ * frame, before any job is released, the scheduler copies the initial image
+ * of every block over the block in one pass. The images are const, so they
+ * stay in flash. The cost of the pass is traced with TRACE_EVENT_STATE_RESET.
+ *
+ * Blocks are defined with TIMELINE_STATE_BLOCK_DEFINE() and registered with
+ * xTimelineStateRegister() before the scheduler is initialised.
+ */
+
+#ifndef TIMELINE_STATE_H
+#define TIMELINE_STATE_H
+
+#include "FreeRTOS.h"
+#include <stddef.h>
+
+// --- Public Configuration ---
+
+/**
+ * @brief Maximum number of registered state blocks.
+ */
+#ifndef TIMELINE_MAX_STATE_BLOCKS
+#define TIMELINE_MAX_STATE_BLOCKS 16
+#endif
+
+/**
+ * @brief Defines a state block and its initial image.
+ *
+ * Declares `static xType xName` and `static const xType xName##Image`; the
+ * initialiser follows the type and may be a braced list.
+ */
+#define TIMELINE_STATE_BLOCK_DEFINE(xName, xType, ...) \
+    static xType xName;                                \
+    static const xType xName##Image = __VA_ARGS__
+
+// --- Public API ---
+
+/**
+ * @brief Registers a block to be restored at the start of every major frame.
+ *
+ * Must be called before xTimelineSchedulerInit(), or while no timeline runs.
+ * The registrations are dropped by vTimelineSchedulerStop().
+ *
+ * @param pvBlock The block.
+ * @param pvImage Initial image of xSize bytes, or NULL to clear the block to zero.
+ * @param xSize Size of the block, in bytes.
+ * @return pdPASS, or pdFAIL if the arguments are invalid or
+ * TIMELINE_MAX_STATE_BLOCKS blocks are registered already.
+ */
+BaseType_t xTimelineStateRegister(void *pvBlock, const void *pvImage, size_t xSize);
+
+/**
+ * @brief Restores every registered block from its image. Called by the scheduler.
+ *
+ * @return The number of bytes restored.
+ */
+size_t xTimelineStateRestore(void);
+
+/**
+ * @brief Returns the number of registered blocks.
+ */
+UBaseType_t uxTimelineStateGetCount(void);
+
+/**
+ * @brief Drops every registration. Called by vTimelineSchedulerStop().
+ */
+void vTimelineStateClear(void);
+
+#endif // TIMELINE_STATE_H
@@ -0,0 +1,608 @@
+/**
+ * @file timeline_stats.c
+ * @brief Implementation of the timeline scheduler timing instrumentation.
+ *
+ * Nominal release instants lie on tick edges. The tick hook records the cycle
+ * count of the latest edge, so the cycle count of any recent edge can be
+ * reconstructed and compared with the cycle count at which the job actually
+ * started.
+ *
+ * In the host simulation build (TIMELINE_SIM) there is no cycle counter; the
+ * time is then the virtual tick count scaled to configCPU_CLOCK_HZ, refined
+ * with the host time elapsed since the latest tick edge. With
+ * TIMELINE_ONESHOT_TIMER the free-running CMSDK timer replaces the SysTick
+ * fallback, as tickless idle reprograms the SysTick.
+ */
+
+#include "timeline_stats.h"
+#include "timeline_arena.h"
+#include "timeline_timer.h"
+#include "uart.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(TIMELINE_SIM)
+#include <time.h>
+#endif
+
+// --- Private Definitions ---
+
+/* Debug and trace registers of the Cortex-M3. */
+#define DEMCR                 (*((volatile uint32_t *)0xE000EDFCUL))
+#define DEMCR_TRCENA          (1UL << 24)
+#define DWT_CTRL              (*((volatile uint32_t *)0xE0001000UL))
+#define DWT_CTRL_CYCCNTENA    (1UL << 0)
+#define DWT_CYCCNT            (*((volatile uint32_t *)0xE0001004UL))
+
+/* SysTick registers, used when the DWT is not implemented. */
+#define SYST_RVR              (*((volatile uint32_t *)0xE000E014UL))
+#define SYST_CVR              (*((volatile uint32_t *)0xE000E018UL))
+#define SCB_ICSR              (*((volatile uint32_t *)0xE000ED04UL))
+#define SCB_ICSR_PENDSTSET    (1UL << 26)
+
+/* Number of busy-loop iterations used to check that CYCCNT is counting. */
+#define DWT_PROBE_ITERATIONS  64
+
+// --- Private State ---
+
+static volatile TickType_t xEdgeTick = 0;   /**< Tick count at the latest tick edge. */
+static volatile uint32_t ulEdgeCycles = 0;  /**< Cycle count at the latest tick edge. */
+#if defined(TIMELINE_SIM)
+static volatile uint64_t ullEdgeHostNs = 0; /**< Host time at the latest tick edge. */
+#endif
+
+#if (TIMELINE_ENABLE_STATS == 1)
+
+/**
+ * @brief Per-task timestamps of the job in progress.
+ */
+typedef struct {
+    uint32_t ulReleaseCycles; /**< Nominal release instant. */
+    uint32_t ulStartCycles;   /**< First instruction of the job. */
+    uint32_t ulEndCycles;     /**< Completion or kill of the job. */
+} JobTimestamps_t;
+
+static BaseType_t xUseDwt = pdFALSE;
+static uint32_t ulCyclesPerTick = 1;
+
+static TimelineTaskStats_t xTaskStats[MAX_TASKS];
+static JobTimestamps_t xJobTimestamps[MAX_TASKS];
+static TimelineSchedulerStats_t xSchedulerStats;
+
+static uint32_t ulFrameStartCycles = 0;     /**< Cycle count at the start of the current frame. */
+static uint32_t ulSchedulerCycles = 0;      /**< Scheduler cycles accumulated in the current frame. */
+static uint32_t ulSchedulerWakeCycles = 0;  /**< Cycle count when the scheduler last woke up. */
+static uint32_t ulStateResetCycles = 0;     /**< Cycle count at the start of the state reset pass. */
+
+/* Utilisation accounting. Updated from the context switch hook, so every
+ * access from task context is done in a critical section. */
+static uint32_t ulSwitchCycles = 0;          /**< Cycle count at the latest context switch. */
+static uint32_t ulCurrentCategory = TIMELINE_UTIL_OTHER; /**< Category of the running task. */
+static UBaseType_t uxCurrentSubframe = 0;    /**< Sub-frame the running time is charged to. */
+static uint32_t ulFrameUtil[TIMELINE_MAX_SUBFRAMES][TIMELINE_UTIL_CATEGORIES]; /**< Current frame. */
+static uint32_t ulWindowUtil[TIMELINE_UTIL_WINDOW_FRAMES][TIMELINE_MAX_SUBFRAMES][TIMELINE_UTIL_CATEGORIES];
+static uint64_t ullWindowSum[TIMELINE_MAX_SUBFRAMES][TIMELINE_UTIL_CATEGORIES];
+static UBaseType_t uxWindowNext = 0;         /**< Slot of ulWindowUtil overwritten by the next frame. */
+static uint32_t ulWindowFrames = 0;          /**< Number of valid slots in ulWindowUtil. */
+
+#endif /* TIMELINE_ENABLE_STATS */
+
+// --- Private Functions ---
+
+#if defined(TIMELINE_SIM)
+/**
+ * @brief Returns the host monotonic time in nanoseconds.
+ */
+static uint64_t prvHostNs(void) {
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000ULL) + (uint64_t)xNow.tv_nsec;
+}
+#endif
+
+#if (TIMELINE_ENABLE_STATS == 1)
+
+/**
+ * @brief Adds a sample to a series.
+ */
+static void prvAddSample(TimelineStatSeries_t *pxSeries, uint32_t ulValue) {
+    if (ulValue < pxSeries->ulMin) {
+        pxSeries->ulMin = ulValue;
+    }
+    if (ulValue > pxSeries->ulMax) {
+        pxSeries->ulMax = ulValue;
+    }
+    pxSeries->ullSum += ulValue;
+    pxSeries->ulCount++;
+}
+
+/**
+ * @brief Empties a series.
+ */
+static void prvClearSeries(TimelineStatSeries_t *pxSeries) {
+    pxSeries->ulMin = UINT32_MAX;
+    pxSeries->ulMax = 0;
+    pxSeries->ullSum = 0;
+    pxSeries->ulCount = 0;
+}
+
+/**
+ * @brief Returns the cycle count of the tick edge at which a tick began.
+ *
+ * The latest edge recorded by the tick hook is moved back by whole tick
+ * periods, which is exact for the recent past.
+ */
+static uint32_t prvCyclesAtTick(TickType_t xTick) {
+    TickType_t xTick0;
+    uint32_t ulCycles0;
+
+    // The tick hook may update the pair in between; read until consistent
+    do {
+        xTick0 = xEdgeTick;
+        ulCycles0 = ulEdgeCycles;
+    } while (xTick0 != xEdgeTick);
+
+    return ulCycles0 - ((uint32_t)(xTick0 - xTick) * ulCyclesPerTick);
+}
+
+/**
+ * @brief Charges the cycles since the latest context switch to the running task.
+ *
+ * Must be called from the context switch hook or in a critical section.
+ */
+static void prvChargeSlice(void) {
+    uint32_t ulNow = ulTimelineStatsGetCycles();
+
+    ulFrameUtil[uxCurrentSubframe][ulCurrentCategory] += ulNow - ulSwitchCycles;
+    ulSwitchCycles = ulNow;
+}
+
+/**
+ * @brief Moves the accounting of the frame that just ended into the rolling window.
+ *
+ * Must be called in a critical section.
+ */
+static void prvCommitFrameUtil(void) {
+    for (UBaseType_t i = 0; i < TIMELINE_MAX_SUBFRAMES; i++) {
+        for (UBaseType_t j = 0; j < TIMELINE_UTIL_CATEGORIES; j++) {
+            ullWindowSum[i][j] -= ulWindowUtil[uxWindowNext][i][j];
+            ullWindowSum[i][j] += ulFrameUtil[i][j];
+        }
+    }
+    memcpy(ulWindowUtil[uxWindowNext], ulFrameUtil, sizeof(ulFrameUtil));
+    memset(ulFrameUtil, 0, sizeof(ulFrameUtil));
+
+    uxWindowNext = (uxWindowNext + 1) % TIMELINE_UTIL_WINDOW_FRAMES;
+    if (ulWindowFrames < TIMELINE_UTIL_WINDOW_FRAMES) {
+        ulWindowFrames++;
+    }
+}
+
+/**
+ * @brief Formats a share of a total as a percentage with one decimal.
+ */
+static void prvFormatPercent(char *pcBuffer, size_t xSize, uint64_t ullPart, uint64_t ullTotal) {
+    uint32_t ulPermille = (ullTotal != 0) ? (uint32_t)((ullPart * 1000U) / ullTotal) : 0;
+
+    snprintf(pcBuffer, xSize, "%3lu.%lu%%", (unsigned long)(ulPermille / 10), (unsigned long)(ulPermille % 10));
+}
+
+/**
+ * @brief Writes one row of the utilisation table.
+ */
+static void prvDumpUtilRow(const char *pcLabel, const uint64_t *pullCycles) {
+    static const char *const pcCategoryNames[TIMELINE_UTIL_CATEGORIES] = {"other", "idle", "sched", "hrt", "srt"};
+    char cLine[160];
+    char cPercent[12];
+    size_t xLength;
+    uint64_t ullTotal = 0;
+
+    for (UBaseType_t j = 0; j < TIMELINE_UTIL_CATEGORIES; j++) {
+        ullTotal += pullCycles[j];
+    }
+
+    xLength = (size_t)snprintf(cLine, sizeof(cLine), "%-10s:", pcLabel);
+    for (UBaseType_t j = 0; j < TIMELINE_UTIL_CATEGORIES && xLength < sizeof(cLine); j++) {
+        prvFormatPercent(cPercent, sizeof(cPercent), pullCycles[j], ullTotal);
+        xLength += (size_t)snprintf(&cLine[xLength], sizeof(cLine) - xLength, " %s %s", pcCategoryNames[j], cPercent);
+    }
+    if (xLength < sizeof(cLine)) {
+        snprintf(&cLine[xLength], sizeof(cLine) - xLength, "\r\n");
+    }
+    uart_puts(cLine);
+}
+
+/**
+ * @brief Formats one series as "min/mean/max", or "-" if it is empty.
+ */
+static void prvFormatSeries(char *pcBuffer, size_t xSize, const TimelineStatSeries_t *pxSeries) {
+    if (pxSeries->ulCount == 0) {
+        snprintf(pcBuffer, xSize, "-");
+    } else {
+        snprintf(pcBuffer, xSize, "%lu/%lu/%lu", (unsigned long)pxSeries->ulMin,
+                 (unsigned long)(pxSeries->ullSum / pxSeries->ulCount), (unsigned long)pxSeries->ulMax);
+    }
+}
+
+#endif /* TIMELINE_ENABLE_STATS */
+
+// --- Public API Implementation ---
+
+void vTimelineStatsTickHook(TickType_t xTickCount) {
+    // The tick count is updated first: the SysTick and simulated cycle
+    // sources derive the whole ticks of the cycle count from it.
+    xEdgeTick = xTickCount;
+#if defined(TIMELINE_SIM)
+    ullEdgeHostNs = prvHostNs();
+#endif
+#if (TIMELINE_ENABLE_STATS == 1)
+    ulEdgeCycles = ulTimelineStatsGetCycles();
+#endif
+}
+
+void vTimelineStatsTaskSwitchedIn(uint32_t ulCategory) {
+#if (TIMELINE_ENABLE_STATS == 1)
+    prvChargeSlice();
+    ulCurrentCategory = (ulCategory < TIMELINE_UTIL_CATEGORIES) ? ulCategory : TIMELINE_UTIL_OTHER;
+#else
+    (void)ulCategory;
+#endif
+}
+
+#if (TIMELINE_ENABLE_STATS == 1)
+
+void vTimelineStatsInit(void) {
+    ulCyclesPerTick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+
+#if defined(TIMELINE_SIM)
+    xUseDwt = pdFALSE;
+#else
+    // Enable the DWT cycle counter and check that it actually counts; QEMU
+    // implements the register block as read-as-zero.
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+    uint32_t ulBefore = DWT_CYCCNT;
+    for (volatile uint32_t i = 0; i < DWT_PROBE_ITERATIONS; i++) {
+    }
+    xUseDwt = (DWT_CYCCNT != ulBefore) ? pdTRUE : pdFALSE;
+#endif
+
+    vTimelineStatsReset();
+}
+
+uint32_t ulTimelineStatsGetCycles(void) {
+    TickType_t xTick;
+    uint32_t ulElapsed;
+
+#if defined(TIMELINE_SIM)
+    uint64_t ullSinceEdge;
+
+    // Whole ticks come from the virtual clock, which skips idle periods; the
+    // host time only places the instant inside the current tick.
+    do {
+        xTick = xEdgeTick;
+        ullSinceEdge = prvHostNs() - ullEdgeHostNs;
+    } while (xTick != xEdgeTick);
+
+    ulElapsed = (uint32_t)((ullSinceEdge * configCPU_CLOCK_HZ) / 1000000000ULL);
+    if (ulElapsed >= ulCyclesPerTick) {
+        ulElapsed = ulCyclesPerTick - 1;
+    }
+    return (uint32_t)xTick * ulCyclesPerTick + ulElapsed;
+#else
+    uint32_t ulPending;
+
+    if (xUseDwt != pdFALSE) {
+        return DWT_CYCCNT;
+    }
+#if (TIMELINE_ONESHOT_TIMER == 1)
+    // The free-running timer keeps counting through tickless idle, unlike the SysTick
+    return ulTimelineTimerNow();
+#endif
+
+    // SysTick counts down from SYST_RVR once per tick. If it has wrapped but
+    // the tick interrupt has not run yet, one more tick has elapsed.
+    do {
+        xTick = xEdgeTick;
+        ulElapsed = SYST_RVR - SYST_CVR;
+        ulPending = ((SCB_ICSR & SCB_ICSR_PENDSTSET) != 0) ? 1 : 0;
+    } while (xTick != xEdgeTick);
+
+    return ((uint32_t)xTick + ulPending) * ulCyclesPerTick + ulElapsed;
+#endif
+}
+
+BaseType_t xTimelineStatsUsesDwt(void) {
+    return xUseDwt;
+}
+
+void vTimelineStatsRelease(UBaseType_t uxTask, TickType_t xReleaseTick) {
+    if (uxTask < MAX_TASKS) {
+        xJobTimestamps[uxTask].ulReleaseCycles = prvCyclesAtTick(xReleaseTick);
+        xTaskStats[uxTask].ulReleases++;
+    }
+}
+
+void vTimelineStatsReleaseElapsed(UBaseType_t uxTask, uint32_t ulElapsedCycles) {
+    if (uxTask < MAX_TASKS) {
+        xJobTimestamps[uxTask].ulReleaseCycles = ulTimelineStatsGetCycles() - ulElapsedCycles;
+        xTaskStats[uxTask].ulReleases++;
+    }
+}
+
+void vTimelineStatsJobStart(UBaseType_t uxTask) {
+    uint32_t ulNow = ulTimelineStatsGetCycles();
+
+    if (uxTask < MAX_TASKS) {
+        xJobTimestamps[uxTask].ulStartCycles = ulNow;
+        prvAddSample(&xTaskStats[uxTask].xReleaseLatency, ulNow - xJobTimestamps[uxTask].ulReleaseCycles);
+    }
+}
+
+void vTimelineStatsJobEnd(UBaseType_t uxTask, BaseType_t xKilled) {
+    uint32_t ulNow = ulTimelineStatsGetCycles();
+
+    if (uxTask >= MAX_TASKS) {
+        return;
+    }
+
+    xJobTimestamps[uxTask].ulEndCycles = ulNow;
+    prvAddSample(&xTaskStats[uxTask].xResponseTime, ulNow - xJobTimestamps[uxTask].ulReleaseCycles);
+    if (xKilled != pdFALSE) {
+        xTaskStats[uxTask].ulKills++;
+    } else {
+        prvAddSample(&xTaskStats[uxTask].xExecutionTime, ulNow - xJobTimestamps[uxTask].ulStartCycles);
+        xTaskStats[uxTask].ulCompletions++;
+    }
+}
+
+uint32_t ulTimelineStatsJobReclaimed(UBaseType_t uxTask) {
+    uint32_t ulLatency;
+
+    if (uxTask >= MAX_TASKS) {
+        return 0;
+    }
+
+    ulLatency = ulTimelineStatsGetCycles() - xJobTimestamps[uxTask].ulEndCycles;
+    prvAddSample(&xTaskStats[uxTask].xReclaimLatency, ulLatency);
+    return ulLatency;
+}
+
+void vTimelineStatsStateResetStart(void) {
+    ulStateResetCycles = ulTimelineStatsGetCycles();
+}
+
+uint32_t ulTimelineStatsStateResetEnd(void) {
+    uint32_t ulCycles = ulTimelineStatsGetCycles() - ulStateResetCycles;
+
+    prvAddSample(&xSchedulerStats.xStateReset, ulCycles);
+    return ulCycles;
+}
+
+#if (TIMELINE_STATS_STACK_PROFILING == 1)
+void vTimelineStatsStackCheck(UBaseType_t uxTask, TaskHandle_t xTask, uint32_t ulStackDepth) {
+    uint32_t ulUsed;
+
+    if (uxTask >= MAX_TASKS || xTask == NULL) {
+        return;
+    }
+
+    // The high-water mark is the least free space since the task was created
+    ulUsed = ulStackDepth - (uint32_t)uxTaskGetStackHighWaterMark(xTask);
+    xTaskStats[uxTask].ulStackDepth = ulStackDepth;
+    if (ulUsed > xTaskStats[uxTask].ulStackPeakWords) {
+        xTaskStats[uxTask].ulStackPeakWords = ulUsed;
+    }
+}
+#endif
+
+void vTimelineStatsTagTask(TaskHandle_t xTask, TimelineUtilCategory_t xCategory) {
+    // The tag holds a category, not a hook function; it is never called
+    vTaskSetApplicationTaskTag(xTask, (TaskHookFunction_t)(uintptr_t)xCategory);
+}
+
+void vTimelineStatsSubframeStart(UBaseType_t uxSubframe) {
+    // The interrupt-safe form, as the tick dispatcher calls this from the tick hook
+    UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    prvChargeSlice();
+    uxCurrentSubframe = (uxSubframe < TIMELINE_MAX_SUBFRAMES) ? uxSubframe : 0;
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+}
+
+void vTimelineStatsSchedulerWake(void) {
+    ulSchedulerWakeCycles = ulTimelineStatsGetCycles();
+}
+
+void vTimelineStatsSchedulerSleep(void) {
+    ulSchedulerCycles += ulTimelineStatsGetCycles() - ulSchedulerWakeCycles;
+}
+
+void vTimelineStatsFrameEnd(void) {
+    uint32_t ulNow = ulTimelineStatsGetCycles();
+    uint32_t ulFrameCycles = ulNow - ulFrameStartCycles;
+    UBaseType_t uxSaved;
+
+    // Close the current slice of scheduler activity at the frame boundary
+    ulSchedulerCycles += ulNow - ulSchedulerWakeCycles;
+    ulSchedulerWakeCycles = ulNow;
+
+    if (ulFrameCycles != 0) {
+        xSchedulerStats.ulLastFrameCycles = ulFrameCycles;
+        xSchedulerStats.ulLastSchedulerCycles = ulSchedulerCycles;
+        prvAddSample(&xSchedulerStats.xSharePermille,
+                     (uint32_t)(((uint64_t)ulSchedulerCycles * 1000U) / ulFrameCycles));
+    }
+
+    ulFrameStartCycles = ulNow;
+    ulSchedulerCycles = 0;
+
+    // The next frame begins in its first sub-frame
+    uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    prvChargeSlice();
+    prvCommitFrameUtil();
+    uxCurrentSubframe = 0;
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+}
+
+BaseType_t xTimelineStatsGetTask(UBaseType_t uxTask, TimelineTaskStats_t *pxStats) {
+    if (uxTask >= MAX_TASKS || pxStats == NULL) {
+        return pdFAIL;
+    }
+    *pxStats = xTaskStats[uxTask];
+    return pdPASS;
+}
+
+void vTimelineStatsGetScheduler(TimelineSchedulerStats_t *pxStats) {
+    if (pxStats != NULL) {
+        *pxStats = xSchedulerStats;
+    }
+}
+
+void vTimelineStatsGetUtilisation(TimelineUtilisation_t *pxUtilisation) {
+    if (pxUtilisation == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    pxUtilisation->ulFrames = ulWindowFrames;
+    memcpy(pxUtilisation->ullCycles, ullWindowSum, sizeof(ullWindowSum));
+    taskEXIT_CRITICAL();
+}
+
+void vTimelineStatsReset(void) {
+    memset(xTaskStats, 0, sizeof(xTaskStats));
+    for (UBaseType_t i = 0; i < MAX_TASKS; i++) {
+        prvClearSeries(&xTaskStats[i].xReleaseLatency);
+        prvClearSeries(&xTaskStats[i].xExecutionTime);
+        prvClearSeries(&xTaskStats[i].xResponseTime);
+        prvClearSeries(&xTaskStats[i].xReclaimLatency);
+    }
+
+    memset(&xSchedulerStats, 0, sizeof(xSchedulerStats));
+    prvClearSeries(&xSchedulerStats.xSharePermille);
+    prvClearSeries(&xSchedulerStats.xStateReset);
+
+    ulFrameStartCycles = ulTimelineStatsGetCycles();
+    ulSchedulerWakeCycles = ulFrameStartCycles;
+    ulSchedulerCycles = 0;
+
+    taskENTER_CRITICAL();
+    memset(ulFrameUtil, 0, sizeof(ulFrameUtil));
+    memset(ulWindowUtil, 0, sizeof(ulWindowUtil));
+    memset(ullWindowSum, 0, sizeof(ullWindowSum));
+    uxWindowNext = 0;
+    ulWindowFrames = 0;
+    uxCurrentSubframe = 0;
+    ulSwitchCycles = ulFrameStartCycles;
+    taskEXIT_CRITICAL();
+}
+
+void vTimelineStatsDump(void) {
+    char cLine[256];
+    char cLatency[40];
+    char cExecution[40];
+    char cResponse[40];
+    const TimelineStatSeries_t *pxShare = &xSchedulerStats.xSharePermille;
+#if defined(TIMELINE_SIM)
+    const char *pcSource = "virtual";
+#elif (TIMELINE_ONESHOT_TIMER == 1)
+    const char *pcSource = (xUseDwt != pdFALSE) ? "DWT" : "Timer1";
+#else
+    const char *pcSource = (xUseDwt != pdFALSE) ? "DWT" : "SysTick";
+#endif
+
+    snprintf(cLine, sizeof(cLine), "--- Timeline stats (cycles, %s, %lu per tick) ---\r\n",
+             pcSource, (unsigned long)ulCyclesPerTick);
+    uart_puts(cLine);
+
+    if (pxShare->ulCount != 0) {
+        uint32_t ulMean = (uint32_t)(pxShare->ullSum / pxShare->ulCount);
+        snprintf(cLine, sizeof(cLine), "Scheduler CPU: min %lu.%lu%% mean %lu.%lu%% max %lu.%lu%%\r\n",
+                 (unsigned long)(pxShare->ulMin / 10), (unsigned long)(pxShare->ulMin % 10),
+                 (unsigned long)(ulMean / 10), (unsigned long)(ulMean % 10),
+                 (unsigned long)(pxShare->ulMax / 10), (unsigned long)(pxShare->ulMax % 10));
+        uart_puts(cLine);
+    }
+
+    if (xSchedulerStats.xStateReset.ulCount != 0) {
+        prvFormatSeries(cLatency, sizeof(cLatency), &xSchedulerStats.xStateReset);
+        snprintf(cLine, sizeof(cLine), "State reset: %s\r\n", cLatency);
+        uart_puts(cLine);
+    }
+
+    TimelineArenaStats_t xArena;
+
+    vTimelineArenaGetStats(&xArena);
+    if (xArena.ulAllocations != 0 || xArena.ulFailures != 0) {
+        snprintf(cLine, sizeof(cLine),
+                 "Arena: peak %lu/%lu bytes, last %lu | alloc %lu fail %lu | worst alloc %lu reset %lu\r\n",
+                 (unsigned long)xArena.xHighWater, (unsigned long)xArena.xSize,
+                 (unsigned long)xArena.xLastPeriodUsed, (unsigned long)xArena.ulAllocations,
+                 (unsigned long)xArena.ulFailures, (unsigned long)xArena.ulAllocCyclesMax,
+                 (unsigned long)xArena.ulResetCyclesMax);
+        uart_puts(cLine);
+    }
+
+    for (UBaseType_t i = 0; i < uxTimelineSchedulerGetTaskCount(); i++) {
+        const TimelineTaskStats_t *pxStats = &xTaskStats[i];
+        const TimelineTaskConfig_t *pxConfig = pxTimelineSchedulerGetTaskConfig(i);
+        char cStack[32] = "";
+        char cReclaim[48] = "";
+
+        prvFormatSeries(cLatency, sizeof(cLatency), &pxStats->xReleaseLatency);
+        prvFormatSeries(cExecution, sizeof(cExecution), &pxStats->xExecutionTime);
+        prvFormatSeries(cResponse, sizeof(cResponse), &pxStats->xResponseTime);
+
+        if (pxStats->ulStackDepth != 0) {
+            snprintf(cStack, sizeof(cStack), " | stack %lu/%lu", (unsigned long)pxStats->ulStackPeakWords,
+                     (unsigned long)pxStats->ulStackDepth);
+        }
+
+        // Only killed jobs are reclaimed
+        if (pxStats->xReclaimLatency.ulCount != 0) {
+            char cSeries[40];
+
+            prvFormatSeries(cSeries, sizeof(cSeries), &pxStats->xReclaimLatency);
+            snprintf(cReclaim, sizeof(cReclaim), " | reclaim %s", cSeries);
+        }
+
+        snprintf(cLine, sizeof(cLine), "%-10s: n %lu ok %lu kill %lu | lat %s | exec %s | resp %s%s%s\r\n",
+                 (pxConfig != NULL) ? pxConfig->pcName : "?",
+                 (unsigned long)pxStats->ulReleases, (unsigned long)pxStats->ulCompletions,
+                 (unsigned long)pxStats->ulKills, cLatency, cExecution, cResponse, cReclaim, cStack);
+        uart_puts(cLine);
+    }
+
+    // Rolling utilisation table, one row per sub-frame and one for the whole frame
+    TimelineUtilisation_t xUtil;
+    uint64_t ullFrameTotal[TIMELINE_UTIL_CATEGORIES] = {0};
+
+    vTimelineStatsGetUtilisation(&xUtil);
+    if (xUtil.ulFrames == 0) {
+        return;
+    }
+
+    snprintf(cLine, sizeof(cLine), "CPU utilisation over the last %lu frames:\r\n", (unsigned long)xUtil.ulFrames);
+    uart_puts(cLine);
+    for (UBaseType_t i = 0; i < TIMELINE_MAX_SUBFRAMES; i++) {
+        char cLabel[16];
+
+        uint64_t ullRowTotal = 0;
+
+        for (UBaseType_t j = 0; j < TIMELINE_UTIL_CATEGORIES; j++) {
+            ullRowTotal += xUtil.ullCycles[i][j];
+            ullFrameTotal[j] += xUtil.ullCycles[i][j];
+        }
+        // Sub-frames beyond the layout of the schedules in use stay empty
+        if (ullRowTotal == 0) {
+            continue;
+        }
+        snprintf(cLabel, sizeof(cLabel), "Subframe %lu", (unsigned long)i);
+        prvDumpUtilRow(cLabel, xUtil.ullCycles[i]);
+    }
+    prvDumpUtilRow("Frame", ullFrameTotal);
+}
+
+#endif /* TIMELINE_ENABLE_STATS */
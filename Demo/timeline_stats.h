@@ -0,0 +1,313 @@
+/**
+ * @file timeline_stats.h
+ * @brief Cycle-accurate timing instrumentation for the timeline scheduler.
+ *
+ * Every release, job start, completion and kill is timestamped with a cycle
+ * counter, giving sub-tick precision. The Cortex-M3 DWT cycle counter is used
+ * when the core implements it; otherwise (e.g. under QEMU, which does not
+ * model the DWT) the time is derived from the tick count and the SysTick
+ * down-counter. Per-task release latency, execution time and response time,
+ * and the scheduler task's CPU share per frame, are accumulated and can be
+ * queried at runtime or dumped to the UART.
+ *
+ * The layer also accounts where the CPU time of each major frame goes. Every
+ * context switch charges the elapsed cycles to the category of the task that
+ * was running (HRT job, SRT job, scheduler, idle or other) and to the current
+ * sub-frame, and the totals of the last few frames form a rolling utilisation
+ * table that shows the capacity headroom of each sub-frame.
+ */
+
+#ifndef TIMELINE_STATS_H
+#define TIMELINE_STATS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timeline_scheduler.h"
+
+// --- Public Configuration ---
+
+/**
+ * @brief Set to 1 to build the instrumentation layer, 0 to compile it out.
+ */
+#ifndef TIMELINE_ENABLE_STATS
+#define TIMELINE_ENABLE_STATS 1
+#endif
+
+/**
+ * @brief Dump the statistics every N major frames. 0 disables periodic dumps.
+ *
+ * The dump is formatted by the scheduler task during the final idle phase of
+ * the frame, so it is meant for validation runs rather than production.
+ */
+#ifndef TIMELINE_STATS_DUMP_PERIOD_FRAMES
+#define TIMELINE_STATS_DUMP_PERIOD_FRAMES 0
+#endif
+
+/**
+ * @brief Number of major frames covered by the rolling utilisation table.
+ */
+#ifndef TIMELINE_UTIL_WINDOW_FRAMES
+#define TIMELINE_UTIL_WINDOW_FRAMES 8
+#endif
+
+/**
+ * @brief Set to 1 to record the stack high-water mark of every job.
+ *
+ * At each completion or kill the scheduler reads uxTaskGetStackHighWaterMark()
+ * of the job's task and keeps the worst case per task, to size the ulStackDepth
+ * of each task from measurements. The call scans the unused part of the stack,
+ * so it lengthens the scheduler's path at every job end and is meant for
+ * profiling runs. Requires INCLUDE_uxTaskGetStackHighWaterMark.
+ */
+#ifndef TIMELINE_STATS_STACK_PROFILING
+#define TIMELINE_STATS_STACK_PROFILING 0
+#endif
+
+/**
+ * @brief Categories of CPU time in the utilisation table.
+ *
+ * The category of a task is stored in its application task tag. Untagged
+ * tasks, such as the trace drain task, are accounted as TIMELINE_UTIL_OTHER.
+ * Interrupt handlers are charged to the task they interrupted.
+ */
+typedef enum {
+    TIMELINE_UTIL_OTHER = 0, /**< Tasks not managed by the timeline scheduler. */
+    TIMELINE_UTIL_IDLE,      /**< The FreeRTOS idle task. */
+    TIMELINE_UTIL_SCHEDULER, /**< The timeline scheduler task. */
+    TIMELINE_UTIL_HRT,       /**< Hard real-time jobs. */
+    TIMELINE_UTIL_SRT,       /**< Soft real-time jobs. */
+    TIMELINE_UTIL_CATEGORIES
+} TimelineUtilCategory_t;
+
+/**
+ * @brief Minimum, maximum and mean of a series of samples.
+ */
+typedef struct {
+    uint32_t ulMin;   /**< Smallest sample, UINT32_MAX if there are none. */
+    uint32_t ulMax;   /**< Largest sample. */
+    uint64_t ullSum;  /**< Sum of all samples, for the mean. */
+    uint32_t ulCount; /**< Number of samples. */
+} TimelineStatSeries_t;
+
+/**
+ * @brief Timing statistics of one managed task. All times are in cycles.
+ */
+typedef struct {
+    TimelineStatSeries_t xReleaseLatency; /**< From the nominal release instant to the first instruction of the job. */
+    TimelineStatSeries_t xExecutionTime;  /**< From the start of the job to its completion. */
+    TimelineStatSeries_t xResponseTime;   /**< From the nominal release instant to completion or kill. */
+    TimelineStatSeries_t xReclaimLatency; /**< From a kill to the deletion of the task and the release of its resources. */
+    uint32_t ulReleases;                  /**< Number of jobs started. */
+    uint32_t ulCompletions;               /**< Number of jobs that completed. */
+    uint32_t ulKills;                     /**< Number of jobs terminated before completing. */
+    uint32_t ulStackDepth;                /**< Stack depth of the job's task in words, 0 until profiled. */
+    uint32_t ulStackPeakWords;            /**< Largest stack use seen at a completion or kill, in words. */
+} TimelineTaskStats_t;
+
+/**
+ * @brief CPU share of the scheduler task, per major frame.
+ */
+typedef struct {
+    uint32_t ulLastFrameCycles;          /**< Length of the last complete frame in cycles. */
+    uint32_t ulLastSchedulerCycles;      /**< Cycles spent in the scheduler task in the last frame. */
+    TimelineStatSeries_t xSharePermille; /**< Scheduler share of each frame, in tenths of a percent. */
+    TimelineStatSeries_t xStateReset;    /**< Cycles spent restoring the registered state blocks at each frame start. */
+} TimelineSchedulerStats_t;
+
+/**
+ * @brief CPU time per sub-frame and category, summed over the rolling window.
+ */
+typedef struct {
+    uint32_t ulFrames; /**< Number of complete frames in the window, at most TIMELINE_UTIL_WINDOW_FRAMES. */
+    uint64_t ullCycles[TIMELINE_MAX_SUBFRAMES][TIMELINE_UTIL_CATEGORIES]; /**< Cycles spent in each category. */
+} TimelineUtilisation_t;
+
+// --- Public API ---
+
+/**
+ * @brief Records the cycle count at a tick interrupt.
+ *
+ * Called from traceTASK_INCREMENT_TICK() in FreeRTOSConfig.h. It anchors the
+ * nominal release instants, which fall on tick edges, to the cycle counter.
+ * Always built, so the hook macro does not depend on TIMELINE_ENABLE_STATS.
+ *
+ * @param xTickCount The tick count after the increment.
+ */
+void vTimelineStatsTickHook(TickType_t xTickCount);
+
+/**
+ * @brief Charges the CPU time since the previous context switch.
+ *
+ * Called from traceTASK_SWITCHED_IN() in FreeRTOSConfig.h with the task tag of
+ * the task being switched in. Always built, like vTimelineStatsTickHook().
+ *
+ * @param ulCategory TimelineUtilCategory_t of the task that now runs.
+ */
+void vTimelineStatsTaskSwitchedIn(uint32_t ulCategory);
+
+#if (TIMELINE_ENABLE_STATS == 1)
+
+/**
+ * @brief Selects the cycle source and clears all statistics.
+ */
+void vTimelineStatsInit(void);
+
+/**
+ * @brief Returns the current value of the cycle counter.
+ *
+ * Safe to call from tasks and ISRs. With the SysTick fallback the value wraps
+ * together with the tick count.
+ */
+uint32_t ulTimelineStatsGetCycles(void);
+
+/**
+ * @brief Returns pdTRUE if the DWT cycle counter is in use, pdFALSE for the SysTick fallback.
+ */
+BaseType_t xTimelineStatsUsesDwt(void);
+
+/**
+ * @brief Marks the release of a job. Called by the scheduler.
+ *
+ * @param uxTask Managed task index.
+ * @param xReleaseTick Tick of the nominal release instant.
+ */
+void vTimelineStatsRelease(UBaseType_t uxTask, TickType_t xReleaseTick);
+
+/**
+ * @brief Marks the release of a job whose nominal instant lies in the past.
+ * Called by the one-shot dispatcher, whose release instants fall between ticks.
+ *
+ * @param uxTask Managed task index.
+ * @param ulElapsedCycles Cycles elapsed since the nominal release instant.
+ */
+void vTimelineStatsReleaseElapsed(UBaseType_t uxTask, uint32_t ulElapsedCycles);
+
+/**
+ * @brief Marks the first instruction of a job. Called by the job wrapper.
+ */
+void vTimelineStatsJobStart(UBaseType_t uxTask);
+
+/**
+ * @brief Marks the end of a job, either completed or killed.
+ *
+ * @param uxTask Managed task index.
+ * @param xKilled pdTRUE if the job was terminated before completing.
+ */
+void vTimelineStatsJobEnd(UBaseType_t uxTask, BaseType_t xKilled);
+
+/**
+ * @brief Marks a killed job as reclaimed: its task deleted and its resources released.
+ *
+ * @param uxTask Managed task index.
+ * @return The cycles elapsed since the job was killed.
+ */
+uint32_t ulTimelineStatsJobReclaimed(UBaseType_t uxTask);
+
+/**
+ * @brief Marks the start of the state reset pass. Called by the scheduler.
+ */
+void vTimelineStatsStateResetStart(void);
+
+/**
+ * @brief Marks the end of the state reset pass. Called by the scheduler.
+ *
+ * @return The cycles spent in the pass.
+ */
+uint32_t ulTimelineStatsStateResetEnd(void);
+
+/**
+ * @brief Marks the scheduler task waking up. Called by the scheduler.
+ */
+void vTimelineStatsSchedulerWake(void);
+
+/**
+ * @brief Marks the scheduler task going to sleep. Called by the scheduler.
+ */
+void vTimelineStatsSchedulerSleep(void);
+
+/**
+ * @brief Sets the utilisation category of a task through its task tag.
+ */
+void vTimelineStatsTagTask(TaskHandle_t xTask, TimelineUtilCategory_t xCategory);
+
+/**
+ * @brief Marks the start of a sub-frame. Called by the scheduler, or from the
+ * tick hook when TIMELINE_TICK_DISPATCH is set.
+ *
+ * @param uxSubframe Id of the sub-frame that starts.
+ */
+void vTimelineStatsSubframeStart(UBaseType_t uxSubframe);
+
+/**
+ * @brief Closes the accounting of a major frame. Called by the scheduler at each
+ * boundary, or from the tick hook when TIMELINE_TICK_DISPATCH is set.
+ */
+void vTimelineStatsFrameEnd(void);
+
+/**
+ * @brief Copies the statistics of a managed task.
+ *
+ * @param uxTask Managed task index.
+ * @param pxStats Receives the statistics.
+ * @return pdPASS on success, pdFAIL if the index is out of range.
+ */
+BaseType_t xTimelineStatsGetTask(UBaseType_t uxTask, TimelineTaskStats_t *pxStats);
+
+/**
+ * @brief Copies the scheduler CPU-share statistics.
+ */
+void vTimelineStatsGetScheduler(TimelineSchedulerStats_t *pxStats);
+
+/**
+ * @brief Copies the rolling utilisation table.
+ */
+void vTimelineStatsGetUtilisation(TimelineUtilisation_t *pxUtilisation);
+
+/**
+ * @brief Clears all accumulated statistics.
+ */
+void vTimelineStatsReset(void);
+
+/**
+ * @brief Writes all statistics to the UART in human-readable form.
+ */
+void vTimelineStatsDump(void);
+
+#else
+
+#define vTimelineStatsInit()
+#define vTimelineStatsRelease(uxTask, xReleaseTick) ((void)(uxTask), (void)(xReleaseTick))
+#define vTimelineStatsReleaseElapsed(uxTask, ulElapsedCycles) ((void)(uxTask), (void)(ulElapsedCycles))
+#define vTimelineStatsJobStart(uxTask)              ((void)(uxTask))
+#define vTimelineStatsJobEnd(uxTask, xKilled)       ((void)(uxTask), (void)(xKilled))
+#define ulTimelineStatsJobReclaimed(uxTask)         ((void)(uxTask), 0UL)
+#define vTimelineStatsStateResetStart()
+#define ulTimelineStatsStateResetEnd()              (0UL)
+#define vTimelineStatsSchedulerWake()
+#define vTimelineStatsSchedulerSleep()
+#define vTimelineStatsTagTask(xTask, xCategory)     ((void)(xTask), (void)(xCategory))
+#define vTimelineStatsSubframeStart(uxSubframe)     ((void)(uxSubframe))
+#define vTimelineStatsFrameEnd()
+#define vTimelineStatsReset()
+
+#endif /* TIMELINE_ENABLE_STATS */
+
+#if (TIMELINE_ENABLE_STATS == 1) && (TIMELINE_STATS_STACK_PROFILING == 1)
+
+/**
+ * @brief Records the stack use of a job that completed or is being killed.
+ * Called by the scheduler before the job's task is reclaimed.
+ *
+ * @param uxTask Managed task index.
+ * @param xTask The job's task.
+ * @param ulStackDepth Stack depth of the task, in words.
+ */
+void vTimelineStatsStackCheck(UBaseType_t uxTask, TaskHandle_t xTask, uint32_t ulStackDepth);
+
+#else
+
+#define vTimelineStatsStackCheck(uxTask, xTask, ulStackDepth) ((void)(uxTask), (void)(xTask), (void)(ulStackDepth))
+
+#endif /* TIMELINE_STATS_STACK_PROFILING */
+
+#endif // TIMELINE_STATS_H
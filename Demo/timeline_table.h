@@ -0,0 +1,181 @@
+/**
+ * @file timeline_table.h
+ * @brief Declarative timelines, checked and compiled at build time.
+ *
+ * A timeline is described once, as an X-macro list of its sub-frames and
+ * tasks, and TIMELINE_DEFINE() turns it into a TimelineConfig_t whose task
+ * array, sorted dispatch table and SRT order are all const data in flash.
+ * Registering such a configuration neither sorts nor copies anything, and it
+ * takes no slot of TIMELINE_MAX_COMPILED_SCHEDULES.
+ *
+ * The list is a function-like macro taking three entry macros:
+ *
+ *     #define DEMO_TIMELINE(SUBFRAME, HRT, SRT)                                   \
+ *         SUBFRAME(0, 0, pdMS_TO_TICKS(50))                                        \
+ *         HRT(HRT1, vTask_HRT1, 0, pdMS_TO_TICKS(10), pdMS_TO_TICKS(40), 0,       \
+ *             TIMELINE_MISS_KILL, 0, NULL)                                         \
+ *         SUBFRAME(1, pdMS_TO_TICKS(50), pdMS_TO_TICKS(100))                       \
+ *         SRT(SRT1, vTask_SRT1, 0)
+ *
+ *     TIMELINE_DEFINE(xMyTimeline, DEMO_TIMELINE);
+ *
+ * - SUBFRAME(id, start, end) opens sub-frame id, spanning [start, end) ticks.
+ *   Sub-frames are declared in order from 0, back to back and all of the
+ *   same length; the major frame ends with the last one.
+ * - HRT(name, function, subframe, start, end, stack, policy, skip, degraded)
+ *   declares a hard real-time task with the window [start, end) in ticks. It
+ *   follows the SUBFRAME() entry of its sub-frame, after the windows that
+ *   precede it. The last four arguments are the ulStackDepth, xMissPolicy,
+ *   ulMissSkipReleases and pvDegradedCode fields of TimelineTaskConfig_t.
+ * - SRT(name, function, stack) declares a soft real-time task. SRT tasks may
+ *   appear anywhere and run in declaration order.
+ *
+ * Every time must be an integer constant expression. A layout that the
+ * scheduler would reject fails to compile with a _Static_assert naming the
+ * problem: sub-frames out of order, of unequal length or too many, an empty
+ * window, a window outside its sub-frame or declared under the wrong one,
+ * overlapping windows, too many tasks or, with the static task pool, stacks
+ * that do not fit in the arena. Only the miss policy handlers are checked at
+ * registration.
+ *
+ * Managed task indices are declaration order, counting HRT and SRT tasks
+ * alike, and the task name is the stringified identifier. Each task also gets
+ * an enumerator TIMELINE_ID_<name> holding its index, so task identifiers
+ * must be unique in the translation unit. Windows are in ticks only, and
+ * every task is released once per major frame: multi-rate tasks (see
+ * ulPeriodTicks) need a configuration compiled at registration.
+ */
+
+#ifndef TIMELINE_TABLE_H
+#define TIMELINE_TABLE_H
+
+#include "timeline_scheduler.h"
+
+// --- Entry Expansions ---
+// Each TIMELINE_DEFINE() pass expands the list with one set of these.
+
+#define TIMELINE_TABLE_NOTHING(...)
+
+/* Managed task indices */
+#define TIMELINE_TABLE_ID_HRT(xName, ...) TIMELINE_ID_##xName,
+#define TIMELINE_TABLE_ID_SRT(xName, ...) TIMELINE_ID_##xName,
+
+/* Counts and sums, as terms of a constant expression */
+#define TIMELINE_TABLE_ONE(...) + 1
+#define TIMELINE_TABLE_SUBFRAME_LENGTH(uxId, ulStart, ulEnd) + ((ulEnd) - (ulStart))
+#define TIMELINE_TABLE_FIRST_LENGTH(uxId, ulStart, ulEnd) + (((uxId) == 0) ? ((ulEnd) - (ulStart)) : 0)
+
+/* Stack words taken from the arena, resolved as prvStackDepth() does */
+#define TIMELINE_TABLE_DEPTH(ulStack)                                                                       \
+    ((((ulStack) != 0) ? (ulStack) : TIMELINE_TASK_STACK_DEPTH) < configMINIMAL_STACK_SIZE                  \
+         ? configMINIMAL_STACK_SIZE : (((ulStack) != 0) ? (ulStack) : TIMELINE_TASK_STACK_DEPTH))
+#define TIMELINE_TABLE_STACK_HRT(xName, pvCode, uxSubframe, ulStart, ulEnd, ulStack, ...) \
+    + TIMELINE_TABLE_DEPTH(ulStack)
+#define TIMELINE_TABLE_STACK_SRT(xName, pvCode, ulStack) + TIMELINE_TABLE_DEPTH(ulStack)
+
+/* Task configurations */
+#define TIMELINE_TABLE_CONFIG_HRT(xName, pvCode, uxSubframe, ulStart, ulEnd, ulStack, xPolicy, ulSkip, pvDegraded) \
+    { .pvTaskCode = (pvCode), .pcName = #xName, .xTaskType = TASK_TYPE_HARD_RT,                                  \
+      .ulStartTimeTicks = (ulStart), .ulEndTimeTicks = (ulEnd), .ulSubframeId = (uxSubframe),                   \
+      .ulStackDepth = (ulStack), .xMissPolicy = (xPolicy), .ulMissSkipReleases = (ulSkip),                      \
+      .pvDegradedCode = (pvDegraded) },
+#define TIMELINE_TABLE_CONFIG_SRT(xName, pvCode, ulStack) \
+    { .pvTaskCode = (pvCode), .pcName = #xName, .xTaskType = TASK_TYPE_SOFT_RT, .ulStackDepth = (ulStack) },
+
+/* Events, in the order prvCompileSchedule() would sort them. A window too
+ * short for an abort request keeps a placeholder next to its release. */
+#define TIMELINE_TABLE_HAS_ABORT(ulStart, ulEnd) \
+    ((TIMELINE_ABORT_LEAD_TICKS > 0) && (((ulEnd) - (ulStart)) > TIMELINE_ABORT_LEAD_TICKS))
+#define TIMELINE_TABLE_EVENT(ulTicks, uxIndex, xKind) \
+    { .ulOffset = (ulTicks) * TIMELINE_UNITS_PER_TICK, .usIndex = (uxIndex), .ucKind = (xKind) },
+#define TIMELINE_TABLE_EVENT_SUBFRAME(uxId, ulStart, ulEnd) \
+    TIMELINE_TABLE_EVENT(ulStart, uxId, TIMELINE_EVENT_SUBFRAME)
+#define TIMELINE_TABLE_EVENT_HRT(xName, pvCode, uxSubframe, ulStart, ulEnd, ...)                                  \
+    TIMELINE_TABLE_EVENT(ulStart, TIMELINE_ID_##xName, TIMELINE_EVENT_RELEASE)                                   \
+    TIMELINE_TABLE_EVENT(TIMELINE_TABLE_HAS_ABORT(ulStart, ulEnd) ? (ulEnd) - TIMELINE_ABORT_LEAD_TICKS : (ulStart), \
+                         TIMELINE_ID_##xName,                                                                    \
+                         TIMELINE_TABLE_HAS_ABORT(ulStart, ulEnd) ? TIMELINE_EVENT_ABORT : TIMELINE_EVENT_NONE)  \
+    TIMELINE_TABLE_EVENT(ulEnd, TIMELINE_ID_##xName, TIMELINE_EVENT_DEADLINE)
+
+/* SRT order */
+#define TIMELINE_TABLE_SOFT_SRT(xName, ...) TIMELINE_ID_##xName,
+
+/* Layout checks. Every sub-frame and HRT entry opens a block whose enumerators
+ * shadow the previous ones, so each entry is checked against the state left
+ * by the entries before it: the sub-frame it is in and the end of the last
+ * window. */
+#define TIMELINE_TABLE_CHECK_SUBFRAME(uxId, ulStart, ulEnd)                                                      \
+    {                                                                                                            \
+        _Static_assert((uxId) == tl_subframes, "SUBFRAME(" #uxId "): sub-frames must be declared in order from 0"); \
+        _Static_assert((ulStart) == tl_subframe_end, "SUBFRAME(" #uxId "): sub-frames must be back to back from 0"); \
+        _Static_assert((ulEnd) > (ulStart), "SUBFRAME(" #uxId "): empty sub-frame");                             \
+        _Static_assert(tl_subframes == 0 || ((ulEnd) - (ulStart)) == (tl_subframe_end - tl_subframe_start),     \
+                       "SUBFRAME(" #uxId "): sub-frames must all have the same length");                        \
+        enum { tl_subframes = (uxId) + 1, tl_subframe_start = (ulStart), tl_subframe_end = (ulEnd) };
+#define TIMELINE_TABLE_CHECK_HRT(xName, pvCode, uxSubframe, ulStart, ulEnd, ...)                                \
+    {                                                                                                            \
+        _Static_assert(tl_subframes > 0 && (uxSubframe) + 1 == tl_subframes,                                     \
+                       "HRT(" #xName "): not declared under the SUBFRAME() entry of its sub-frame");             \
+        _Static_assert((ulStart) < (ulEnd), "HRT(" #xName "): empty window");                                    \
+        _Static_assert((ulStart) >= tl_subframe_start && (ulEnd) <= tl_subframe_end,                             \
+                       "HRT(" #xName "): window outside its sub-frame");                                         \
+        _Static_assert((ulStart) >= tl_busy_until,                                                               \
+                       "HRT(" #xName "): window overlaps, or is declared before, the previous window");          \
+        enum { tl_busy_until = (ulEnd) };
+#define TIMELINE_TABLE_CLOSE(...) }
+
+// --- Public Macros ---
+
+/**
+ * @brief Defines `const TimelineConfig_t xName` from the timeline list xList.
+ *
+ * Also defines xName##Tasks, xName##Events, xName##SoftOrder and
+ * xName##Table, and the enumerators TIMELINE_ID_<task>; see the file
+ * comment for the list format.
+ */
+#define TIMELINE_DEFINE(xName, xList)                                                                            \
+    enum { xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_ID_HRT, TIMELINE_TABLE_ID_SRT) };                       \
+                                                                                                                 \
+    _Pragma("GCC diagnostic push")                                                                               \
+    _Pragma("GCC diagnostic ignored \"-Wshadow\"")                                                               \
+    static inline void xName##Check(void) {                                                                      \
+        enum { tl_subframes = 0, tl_subframe_start = 0, tl_subframe_end = 0, tl_busy_until = 0 };                \
+        xList(TIMELINE_TABLE_CHECK_SUBFRAME, TIMELINE_TABLE_CHECK_HRT, TIMELINE_TABLE_NOTHING)                   \
+        _Static_assert(tl_subframes > 0, #xName ": a timeline needs at least one sub-frame");                    \
+        _Static_assert(tl_subframes <= TIMELINE_MAX_SUBFRAMES, #xName ": more than TIMELINE_MAX_SUBFRAMES sub-frames"); \
+        xList(TIMELINE_TABLE_CLOSE, TIMELINE_TABLE_CLOSE, TIMELINE_TABLE_NOTHING)                                \
+    }                                                                                                            \
+    _Pragma("GCC diagnostic pop")                                                                                \
+                                                                                                                 \
+    _Static_assert((0 xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_ONE, TIMELINE_TABLE_ONE)) <= MAX_TASKS,        \
+                   #xName ": more than MAX_TASKS tasks");                                                        \
+    _Static_assert((TIMELINE_USE_STATIC_TASK_POOL == 0) ||                                                       \
+                   (0 xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_STACK_HRT, TIMELINE_TABLE_STACK_SRT))          \
+                       <= TIMELINE_STACK_ARENA_WORDS,                                                            \
+                   #xName ": task stacks exceed TIMELINE_STACK_ARENA_WORDS");                                    \
+                                                                                                                 \
+    static const TimelineTaskConfig_t xName##Tasks[] = {                                                         \
+        xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_CONFIG_HRT, TIMELINE_TABLE_CONFIG_SRT)                      \
+    };                                                                                                           \
+    static const TimelineEvent_t xName##Events[] = {                                                             \
+        xList(TIMELINE_TABLE_EVENT_SUBFRAME, TIMELINE_TABLE_EVENT_HRT, TIMELINE_TABLE_NOTHING)                   \
+    };                                                                                                           \
+    /* The trailing 0 keeps the array non-empty without SRT tasks; it is not counted */                          \
+    static const uint16_t xName##SoftOrder[] = {                                                                 \
+        xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_SOFT_SRT) 0                         \
+    };                                                                                                           \
+    static const TimelineTable_t xName##Table = {                                                                \
+        .pxEvents = xName##Events,                                                                               \
+        .usEventCount = sizeof(xName##Events) / sizeof(TimelineEvent_t),                                         \
+        .pusSoftTaskOrder = xName##SoftOrder,                                                                    \
+        .usSoftTaskCount = (0 xList(TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_ONE)),        \
+    };                                                                                                           \
+    const TimelineConfig_t xName = {                                                                             \
+        .pxTasks = xName##Tasks,                                                                                 \
+        .uxNumTasks = sizeof(xName##Tasks) / sizeof(TimelineTaskConfig_t),                                       \
+        .ulMajorFrameTicks = (0 xList(TIMELINE_TABLE_SUBFRAME_LENGTH, TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_NOTHING)), \
+        .ulSubframeTicks = (0 xList(TIMELINE_TABLE_FIRST_LENGTH, TIMELINE_TABLE_NOTHING, TIMELINE_TABLE_NOTHING)), \
+        .pxTable = &xName##Table,                                                                                \
+    }
+
+#endif // TIMELINE_TABLE_H
@@ -0,0 +1,81 @@
+/**
+ * @file timeline_timer.c
+ * @brief Implementation of the CMSDK timer driver for the one-shot dispatcher.
+ *
+ * A CMSDK timer counts down from its VALUE register and raises its interrupt
+ * when it reaches zero, then reloads from RELOAD. Timer1 reloads with the
+ * largest value, so its complement is a clock that counts up and wraps at
+ * exactly 2^32. Timer0 is stopped in its own interrupt, before it reloads
+ * into a second expiry.
+ */
+
+#include "timeline_timer.h"
+
+#if (TIMELINE_ONESHOT_TIMER == 1)
+
+// --- Private Definitions ---
+
+/* NVIC registers used to enable and prioritise the Timer0 interrupt. */
+#define NVIC_ISER0     (*((volatile uint32_t *)0xE000E100UL))
+#define NVIC_ICPR0     (*((volatile uint32_t *)0xE000E280UL))
+#define NVIC_IPR_BASE  ((volatile uint8_t *)0xE000E400UL)
+
+/* The handler notifies tasks, so it must not run above the kernel's syscall priority. */
+#define TIMER0_IRQ_PRIORITY (configKERNEL_INTERRUPT_PRIORITY)
+
+// The clock casts of the FreeRTOS configuration keep this out of the preprocessor
+_Static_assert((TIMELINE_TIMER_HZ % 1000000UL) == 0 && (TIMELINE_TIMER_HZ % configTICK_RATE_HZ) == 0,
+               "TIMELINE_TIMER_HZ must be a whole number of MHz and a multiple of configTICK_RATE_HZ");
+
+// --- Public API Implementation ---
+
+void vTimelineTimerInit(void) {
+    TIMER_CTRL(TIMER1_ADDRESS) = 0;
+    TIMER_RELOAD(TIMER1_ADDRESS) = UINT32_MAX;
+    TIMER_VALUE(TIMER1_ADDRESS) = UINT32_MAX;
+    TIMER_CTRL(TIMER1_ADDRESS) = TIMER_CTRL_EN;
+
+    vTimelineTimerDisarm();
+    NVIC_IPR_BASE[TIMER0_IRQn] = TIMER0_IRQ_PRIORITY;
+    NVIC_ISER0 = (1UL << TIMER0_IRQn);
+}
+
+uint32_t ulTimelineTimerNow(void) {
+    return ~TIMER_VALUE(TIMER1_ADDRESS);
+}
+
+void vTimelineTimerArm(uint32_t ulTarget) {
+    uint32_t ulDelay;
+
+    // Stop first: writing VALUE of a running timer could fire on the old count
+    TIMER_CTRL(TIMER0_ADDRESS) = 0;
+    ulDelay = ulTarget - ulTimelineTimerNow();
+
+    // Past targets wrap to large delays; anything above half the range is late
+    if (ulDelay < TIMELINE_TIMER_MIN_CYCLES || ulDelay > (UINT32_MAX >> 1)) {
+        ulDelay = TIMELINE_TIMER_MIN_CYCLES;
+    }
+
+    TIMER_RELOAD(TIMER0_ADDRESS) = ulDelay;
+    TIMER_VALUE(TIMER0_ADDRESS) = ulDelay;
+    TIMER_CTRL(TIMER0_ADDRESS) = TIMER_CTRL_EN | TIMER_CTRL_IRQ_EN;
+}
+
+void vTimelineTimerDisarm(void) {
+    TIMER_CTRL(TIMER0_ADDRESS) = 0;
+    TIMER_INTCLEAR(TIMER0_ADDRESS) = 1;
+    NVIC_ICPR0 = (1UL << TIMER0_IRQn);
+}
+
+void TIMER0_Handler(void) {
+    BaseType_t xHigherPriorityTaskWoken;
+
+    // One-shot: stop before the reload expires again, the dispatcher re-arms
+    TIMER_CTRL(TIMER0_ADDRESS) = 0;
+    TIMER_INTCLEAR(TIMER0_ADDRESS) = 1;
+
+    xHigherPriorityTaskWoken = xTimelineSchedulerTimerHook();
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+#endif /* TIMELINE_ONESHOT_TIMER */
@@ -0,0 +1,81 @@
+/**
+ * @file timeline_timer.h
+ * @brief CMSDK timer driver for the one-shot timeline dispatcher.
+ *
+ * Used when TIMELINE_ONESHOT_TIMER is set. Timer1 runs freely from the
+ * reset value down to zero and provides a 32-bit clock at TIMELINE_TIMER_HZ
+ * that keeps counting through tickless idle. Timer0 is armed as a one-shot
+ * at the instant of the next timeline event; its interrupt runs the
+ * dispatcher. Times are absolute values of the Timer1 clock and compare
+ * modulo 2^32.
+ */
+
+#ifndef TIMELINE_TIMER_H
+#define TIMELINE_TIMER_H
+
+#include "timeline_scheduler.h"
+
+#if (TIMELINE_ONESHOT_TIMER == 1)
+
+/* CMSDK APB timers of the MPS2 AN385. */
+#define TIMER0_ADDRESS        (0x40000000UL)
+#define TIMER1_ADDRESS        (0x40001000UL)
+#define TIMER_CTRL(base)      (*((volatile uint32_t *)((base) + 0x00UL)))
+#define TIMER_VALUE(base)     (*((volatile uint32_t *)((base) + 0x04UL)))
+#define TIMER_RELOAD(base)    (*((volatile uint32_t *)((base) + 0x08UL)))
+#define TIMER_INTCLEAR(base)  (*((volatile uint32_t *)((base) + 0x0CUL)))
+
+/* CMSDK APB timer register bits. */
+#define TIMER_CTRL_EN         (1UL << 0)
+#define TIMER_CTRL_IRQ_EN     (1UL << 3)
+
+/* Timer0 interrupt on the MPS2 AN385. */
+#define TIMER0_IRQn           (8UL)
+
+/**
+ * @brief Shortest delay, in timer cycles, the one-shot is armed with.
+ *
+ * An event that is already due, or closer than this, fires after this delay
+ * so that its interrupt is never lost between reading the clock and arming.
+ */
+#ifndef TIMELINE_TIMER_MIN_CYCLES
+#define TIMELINE_TIMER_MIN_CYCLES 64UL
+#endif
+
+/**
+ * @brief Starts the free-running clock and prepares the one-shot interrupt.
+ *
+ * Leaves the one-shot disarmed. Can be called again to restart.
+ */
+void vTimelineTimerInit(void);
+
+/**
+ * @brief Returns the current value of the free-running clock.
+ *
+ * Counts up at TIMELINE_TIMER_HZ and wraps at 2^32. Safe to call from tasks and ISRs.
+ */
+uint32_t ulTimelineTimerNow(void);
+
+/**
+ * @brief Arms the one-shot to fire at an absolute time of the clock.
+ *
+ * Replaces any earlier arming. Targets in the past, or closer than
+ * TIMELINE_TIMER_MIN_CYCLES, fire after TIMELINE_TIMER_MIN_CYCLES.
+ *
+ * @param ulTarget Absolute time, as returned by ulTimelineTimerNow().
+ */
+void vTimelineTimerArm(uint32_t ulTarget);
+
+/**
+ * @brief Stops the one-shot without firing.
+ */
+void vTimelineTimerDisarm(void);
+
+/**
+ * @brief Timer0 interrupt handler, installed in the vector table.
+ */
+void TIMER0_Handler(void);
+
+#endif /* TIMELINE_ONESHOT_TIMER */
+
+#endif // TIMELINE_TIMER_H
@@ -2,49 +2,392 @@
  * @file trace.c
  * @brief Implementation of the scheduler tracing system.
  *
- * This module provides a simple, thread-safe logging mechanism to record
- * scheduler events. It uses a mutex to protect access to the underlying
- * communication peripheral (e.g., UART).
+ * Records are written into a multi-producer, single-consumer ring buffer.
+ * Producers reserve a slot with a compare-and-swap on the head index, fill it
+ * in and then mark it valid, so no mutex is needed and a producer preempted
+ * by another one (task or ISR) never blocks it. The drain task is the only
+ * consumer: it formats or encodes the records and writes them to the UART.
  */
 
 #include "trace.h"
-#include "uart.h" // Assuming a simple UART driver for output
-#include "semphr.h"
+#include "task.h"
+#include "uart.h"
 #include <stdio.h>
+#include <string.h>
 
 // --- Private State ---
 
-static SemaphoreHandle_t xTraceMutex = NULL;
+static TraceRecord_t xTraceBuffer[TRACE_BUFFER_LENGTH];
+static uint32_t ulTraceHead = 0;     /**< Index of the next slot to reserve, written by producers. */
+static uint32_t ulTraceTail = 0;     /**< Index of the next slot to consume, written by the drain task. */
+static uint32_t ulTraceDropped = 0;  /**< Records lost because the buffer was full. */
+
+static const char *pcTraceTaskNames[TRACE_MAX_TASK_NAMES];
+static TaskHandle_t xTraceDrainTaskHandle = NULL;
+static volatile TraceRecordHook_t xTraceRecordHook = NULL;
+
+#if (TRACE_OUTPUT_BINARY == 1)
+/* Largest encoding of one record: header, tick sync and event packets */
+#define TRACE_RECORD_MAX_BYTES ((4 + 5) + (1 + 5) + (1 + 5 + 5 + 5 + 2))
+
+#if TRACE_BINARY_BATCH_BYTES < TRACE_RECORD_MAX_BYTES
+#error "TRACE_BINARY_BATCH_BYTES must hold the largest encoding of one record"
+#endif
+
+// Binary writer state, owned by the drain task
+static uint8_t ucTraceBatch[TRACE_BINARY_BATCH_BYTES];
+static size_t xTraceBatchLength = 0;
+static uint32_t ulTraceLastTick = 0;
+static BaseType_t xTraceInSync = pdFALSE; /**< pdFALSE until the header and a tick sync were output. */
+static const char *pcTraceSentNames[TRACE_MAX_TASK_NAMES]; /**< Names as last sent, NULL if not yet. */
+#endif
+
+// --- Private Functions ---
+
+/**
+ * @brief Removes the oldest record from the ring buffer.
+ *
+ * @param pxRecord Receives the record.
+ * @return pdTRUE if a record was read, pdFALSE if none is ready.
+ */
+static BaseType_t prvTraceRead(TraceRecord_t *pxRecord) {
+    uint32_t ulTail = ulTraceTail;
+    TraceRecord_t *pxSlot = &xTraceBuffer[ulTail & (TRACE_BUFFER_LENGTH - 1)];
+
+    // A reserved slot that is not valid yet is still being written; stop there
+    if (__atomic_load_n(&pxSlot->ucValid, __ATOMIC_ACQUIRE) == 0) {
+        return pdFALSE;
+    }
+
+    *pxRecord = *pxSlot;
+    pxSlot->ucValid = 0;
+    __atomic_store_n(&ulTraceTail, ulTail + 1, __ATOMIC_RELEASE);
+
+    return pdTRUE;
+}
+
+#if (TRACE_OUTPUT_BINARY == 0)
+/**
+ * @brief Returns the printable name of a task id.
+ */
+static const char *prvTraceTaskName(uint16_t usTaskId) {
+    if (usTaskId == TRACE_TASK_ID_SCHEDULER) {
+        return "Scheduler";
+    }
+    if (usTaskId < TRACE_MAX_TASK_NAMES && pcTraceTaskNames[usTaskId] != NULL) {
+        return pcTraceTaskNames[usTaskId];
+    }
+    return "?";
+}
+
+/**
+ * @brief Formats one record and writes it to the UART.
+ */
+static void prvTracePrint(const TraceRecord_t *pxRecord) {
+    char cBuffer[100];
+    char cName[24];
+    const char *pcName = prvTraceTaskName(pxRecord->usTaskId);
+    const char *pcEventStr = "UNKNOWN";
+    BaseType_t xHasArg = pdFALSE;
+
+    switch (pxRecord->ucEvent) {
+        case TRACE_EVENT_MAJOR_FRAME_START: pcEventStr = "MAJOR_FRAME_START"; break;
+        case TRACE_EVENT_TASK_SPAWN:        pcEventStr = (pxRecord->ulArg != 0) ? "SPAWN_DEGRADED" : "SPAWN"; break;
+        case TRACE_EVENT_TASK_COMPLETE:     pcEventStr = "COMPLETE"; break;
+        case TRACE_EVENT_DEADLINE_MISS:     pcEventStr = "DEADLINE_MISS"; break;
+        case TRACE_EVENT_TASK_CREATE_FAILED:pcEventStr = "CREATE_FAILED"; break;
+        case TRACE_EVENT_IDLE_START:        pcEventStr = "IDLE_START"; break;
+        case TRACE_EVENT_IDLE_END:          pcEventStr = "IDLE_END"; break;
+        case TRACE_EVENT_SUBFRAME_START:    pcEventStr = "SUBFRAME_START"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_RELEASE_SKIPPED:
+            pcEventStr = (pxRecord->ulArg == TRACE_SKIP_POLICY) ? "POLICY -> SKIP" : "OVERRUN -> SKIP";
+            break;
+        case TRACE_EVENT_FRAME_OVERRUN:     pcEventStr = "FRAME_OVERRUN"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_SRT_INCOMPLETE:    pcEventStr = "SRT_INCOMPLETE"; break;
+        case TRACE_EVENT_SWITCH_REQUEST:    pcEventStr = "SWITCH_REQUEST"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_SCHEDULE_SWITCH:   pcEventStr = "SCHEDULE_SWITCH"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_STACK_OVERFLOW:    pcEventStr = "STACK_OVERFLOW"; break;
+        case TRACE_EVENT_ABORT_REQUEST:     pcEventStr = "ABORT_REQUEST"; break;
+        case TRACE_EVENT_JOB_ABORTED:       pcEventStr = "JOB_ABORTED"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_JOB_RECLAIMED:     pcEventStr = "JOB_RECLAIMED"; xHasArg = pdTRUE; break;
+        case TRACE_EVENT_STATE_RESET:       pcEventStr = "STATE_RESET"; xHasArg = pdTRUE; break;
+    }
+
+    // The jobs of a multi-rate task are told apart by their instance, as in "Ctrl#3"
+    if (pxRecord->ucInstance != 0) {
+        snprintf(cName, sizeof(cName), "%s#%u", prvTraceTaskName(pxRecord->usTaskId), (unsigned)pxRecord->ucInstance);
+        pcName = cName;
+    }
+
+    if (xHasArg != pdFALSE) {
+        snprintf(cBuffer, sizeof(cBuffer), "[%5lu] %-10s: %s %lu\r\n", (unsigned long)pxRecord->ulTick,
+                 pcName, pcEventStr, (unsigned long)pxRecord->ulArg);
+    } else {
+        snprintf(cBuffer, sizeof(cBuffer), "[%5lu] %-10s: %s\r\n", (unsigned long)pxRecord->ulTick,
+                 pcName, pcEventStr);
+    }
+
+    uart_puts(cBuffer);
+}
+
+#define prvTraceOutput(pxRecord) prvTracePrint(pxRecord)
+
+/**
+ * @brief Reports records lost in the ring buffer.
+ */
+static void prvTraceOutputDropped(uint32_t ulCount) {
+    char cBuffer[64];
+
+    snprintf(cBuffer, sizeof(cBuffer), "[%5lu] Trace     : DROPPED %lu\r\n",
+             (unsigned long)xTaskGetTickCount(), (unsigned long)ulCount);
+    uart_puts(cBuffer);
+}
+
+#define prvTraceFlush()
+
+#else
+
+/**
+ * @brief Writes packets to the UART.
+ *
+ * The UART takes or drops a write as a whole. After a drop the decoder has
+ * lost a tick delta and possibly a name, so the header, a tick sync and the
+ * names are sent again before the next record.
+ */
+static void prvTraceWrite(const uint8_t *pucData, size_t xLength) {
+    if (UART_write((const char *)pucData, xLength) != xLength) {
+        xTraceInSync = pdFALSE;
+        memset(pcTraceSentNames, 0, sizeof(pcTraceSentNames));
+    }
+}
+
+/**
+ * @brief Writes the gathered packets to the UART.
+ */
+static void prvTraceFlush(void) {
+    if (xTraceBatchLength != 0) {
+        prvTraceWrite(ucTraceBatch, xTraceBatchLength);
+        xTraceBatchLength = 0;
+    }
+}
+
+/**
+ * @brief Appends a varint to a packet.
+ *
+ * @return The number of bytes written, at most 5.
+ */
+static size_t prvTraceVarint(uint8_t *pucOut, uint32_t ulValue) {
+    size_t xLength = 0;
+
+    while (ulValue >= 0x80U) {
+        pucOut[xLength++] = (uint8_t)(ulValue | 0x80U);
+        ulValue >>= 7;
+    }
+    pucOut[xLength++] = (uint8_t)ulValue;
+
+    return xLength;
+}
+
+/**
+ * @brief Adds a packet to the batch, flushing first if it does not fit.
+ */
+static void prvTracePut(const uint8_t *pucPacket, size_t xLength) {
+    if (xTraceBatchLength + xLength > sizeof(ucTraceBatch)) {
+        prvTraceFlush();
+    }
+    if (xLength > sizeof(ucTraceBatch)) {
+        // Only a long name gets here; write it on its own
+        prvTraceWrite(pucPacket, xLength);
+        return;
+    }
+    memcpy(&ucTraceBatch[xTraceBatchLength], pucPacket, xLength);
+    xTraceBatchLength += xLength;
+}
+
+/**
+ * @brief Sends the name of a task id if the decoder does not have it yet.
+ */
+static void prvTraceOutputName(uint16_t usTaskId) {
+    uint8_t ucPacket[1 + 5 + 1 + 255];
+    const char *pcName;
+    size_t xLength;
+    size_t xNameLength;
+
+    if (usTaskId >= TRACE_MAX_TASK_NAMES) {
+        return;
+    }
+    pcName = pcTraceTaskNames[usTaskId];
+    if (pcName == NULL || pcName == pcTraceSentNames[usTaskId]) {
+        return;
+    }
+
+    xNameLength = strlen(pcName);
+    if (xNameLength > 255) {
+        xNameLength = 255;
+    }
+    // Marked first: a failed write clears the mark again
+    pcTraceSentNames[usTaskId] = pcName;
+
+    ucPacket[0] = TRACE_PACKET_NAME;
+    xLength = 1 + prvTraceVarint(&ucPacket[1], usTaskId);
+    ucPacket[xLength++] = (uint8_t)xNameLength;
+    memcpy(&ucPacket[xLength], pcName, xNameLength);
+    prvTracePut(ucPacket, xLength + xNameLength);
+}
+
+/**
+ * @brief Encodes one record into the batch.
+ *
+ * Ticks are sent as the difference from the previous record, which may be
+ * negative when a producer was preempted between reading the tick and
+ * reserving its slot. Major frame starts carry an absolute tick so that a
+ * capture started at any point decodes from the next frame on.
+ */
+static void prvTraceOutput(const TraceRecord_t *pxRecord) {
+    uint8_t ucPacket[1 + 5 + 5 + 5 + 2];
+    size_t xLength;
+    int32_t lDelta;
+
+    prvTraceOutputName(pxRecord->usTaskId);
+
+    // The header, sync and event packets go out in the same write, so that a
+    // drop cannot separate them
+    if (xTraceBatchLength + TRACE_RECORD_MAX_BYTES > sizeof(ucTraceBatch)) {
+        prvTraceFlush();
+    }
+    if (xTraceInSync == pdFALSE) {
+        ucPacket[0] = TRACE_PACKET_HEADER;
+        ucPacket[1] = 'T';
+        ucPacket[2] = 'L';
+        ucPacket[3] = TRACE_BINARY_VERSION;
+        xLength = 4 + prvTraceVarint(&ucPacket[4], configTICK_RATE_HZ);
+        prvTracePut(ucPacket, xLength);
+    }
+    if (xTraceInSync == pdFALSE || pxRecord->ucEvent == TRACE_EVENT_MAJOR_FRAME_START) {
+        ucPacket[0] = TRACE_PACKET_SYNC;
+        xLength = 1 + prvTraceVarint(&ucPacket[1], pxRecord->ulTick);
+        prvTracePut(ucPacket, xLength);
+        ulTraceLastTick = pxRecord->ulTick;
+        xTraceInSync = pdTRUE;
+    }
+
+    lDelta = (int32_t)(pxRecord->ulTick - ulTraceLastTick);
+    ulTraceLastTick = pxRecord->ulTick;
+
+    ucPacket[0] = (uint8_t)(((pxRecord->ucInstance != 0) ? TRACE_PACKET_INSTANCE : TRACE_PACKET_EVENT) +
+                            pxRecord->ucEvent);
+    xLength = 1 + prvTraceVarint(&ucPacket[1], ((uint32_t)lDelta << 1) ^ (uint32_t)(lDelta >> 31));
+    xLength += prvTraceVarint(&ucPacket[xLength], (uint16_t)(pxRecord->usTaskId + 1U));
+    xLength += prvTraceVarint(&ucPacket[xLength], pxRecord->ulArg);
+    if (pxRecord->ucInstance != 0) {
+        xLength += prvTraceVarint(&ucPacket[xLength], pxRecord->ucInstance);
+    }
+    prvTracePut(ucPacket, xLength);
+}
+
+/**
+ * @brief Reports records lost in the ring buffer.
+ */
+static void prvTraceOutputDropped(uint32_t ulCount) {
+    uint8_t ucPacket[1 + 5];
+
+    ucPacket[0] = TRACE_PACKET_DROPPED;
+    prvTracePut(ucPacket, 1 + prvTraceVarint(&ucPacket[1], ulCount));
+}
+
+#endif
+
+/**
+ * @brief Drain task: empties the ring buffer and outputs the records.
+ *
+ * Runs at a low priority so that formatting and UART output never delay the
+ * scheduler or the jobs. Losses are reported as soon as they are noticed.
+ *
+ * @param pvParameters Unused.
+ */
+static void prvTraceDrainTask(void *pvParameters) {
+    TraceRecord_t xRecord;
+    uint32_t ulReportedDropped = 0;
+
+    (void)pvParameters;
+
+    for (;;) {
+        while (prvTraceRead(&xRecord) == pdTRUE) {
+            prvTraceOutput(&xRecord);
+        }
+
+        uint32_t ulDropped = ulTraceGetDroppedCount();
+        if (ulDropped != ulReportedDropped) {
+            prvTraceOutputDropped(ulDropped - ulReportedDropped);
+            ulReportedDropped = ulDropped;
+        }
+        prvTraceFlush();
+
+        vTaskDelay(TRACE_DRAIN_PERIOD_TICKS);
+    }
+}
 
 // --- Public API Implementation ---
 
 void vTraceInit(void) {
-    xTraceMutex = xSemaphoreCreateMutex();
-    if (xTraceMutex != NULL) {
-        // Initialization successful
+    if (xTraceDrainTaskHandle != NULL) {
+        return;
     }
+
+    xTaskCreate(prvTraceDrainTask,
+                "TraceDrain",
+                TRACE_DRAIN_TASK_STACK_DEPTH,
+                NULL,
+                TRACE_DRAIN_TASK_PRIORITY,
+                &xTraceDrainTaskHandle);
 }
 
-void vTraceLog(TraceEvent_t xEvent, const char *pcTaskName, TickType_t xTick) {
-    if (xSemaphoreTake(xTraceMutex, portMAX_DELAY) == pdPASS) {
-        char cBuffer[100];
-        const char *pcEventStr = "UNKNOWN";
+void vTraceSetTaskName(uint16_t usTaskId, const char *pcName) {
+    if (usTaskId < TRACE_MAX_TASK_NAMES) {
+        pcTraceTaskNames[usTaskId] = pcName;
+    }
+}
 
-        switch (xEvent) {
-            case TRACE_EVENT_MAJOR_FRAME_START: pcEventStr = "MAJOR_FRAME_START"; break;
-            case TRACE_EVENT_TASK_SPAWN:        pcEventStr = "SPAWN"; break;
-            case TRACE_EVENT_TASK_COMPLETE:     pcEventStr = "COMPLETE"; break;
-            case TRACE_EVENT_DEADLINE_MISS:     pcEventStr = "DEADLINE_MISS"; break;
-            case TRACE_EVENT_TASK_CREATE_FAILED:pcEventStr = "CREATE_FAILED"; break;
-            case TRACE_EVENT_IDLE_START:        pcEventStr = "IDLE_START"; break;
-            case TRACE_EVENT_IDLE_END:          pcEventStr = "IDLE_END"; break;
-        }
+void vTraceLog(TraceEvent_t xEvent, uint16_t usTaskId, TickType_t xTick, uint32_t ulArg) {
+    vTraceLogInstance(xEvent, usTaskId, 0, xTick, ulArg);
+}
 
-        sprintf(cBuffer, "[%5lu] %-10s: %s\r\n", (unsigned long)xTick, pcTaskName, pcEventStr);
-        
-        // Assuming uart_puts is a function from your uart driver
-        uart_puts(cBuffer);
+void vTraceLogInstance(TraceEvent_t xEvent, uint16_t usTaskId, uint8_t ucInstance, TickType_t xTick, uint32_t ulArg) {
+    uint32_t ulHead = __atomic_load_n(&ulTraceHead, __ATOMIC_RELAXED);
+    TraceRecord_t *pxSlot;
+    TraceRecordHook_t xHook = xTraceRecordHook;
 
-        xSemaphoreGive(xTraceMutex);
+    if (xHook != NULL) {
+        TraceRecord_t xRecord = {(uint32_t)xTick, usTaskId, (uint8_t)xEvent, 1, ulArg, ucInstance};
+        xHook(&xRecord);
     }
+
+    // Reserve a slot. The loop only repeats if a task or ISR that preempted us
+    // reserved a slot in between, so the number of iterations is bounded by
+    // the interrupt nesting depth.
+    do {
+        if ((ulHead - __atomic_load_n(&ulTraceTail, __ATOMIC_ACQUIRE)) >= TRACE_BUFFER_LENGTH) {
+            (void)__atomic_fetch_add(&ulTraceDropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&ulTraceHead, &ulHead, ulHead + 1, pdFALSE,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    pxSlot = &xTraceBuffer[ulHead & (TRACE_BUFFER_LENGTH - 1)];
+    pxSlot->ulTick = (uint32_t)xTick;
+    pxSlot->usTaskId = usTaskId;
+    pxSlot->ucEvent = (uint8_t)xEvent;
+    pxSlot->ulArg = ulArg;
+    pxSlot->ucInstance = ucInstance;
+
+    // Publish the record to the drain task
+    __atomic_store_n(&pxSlot->ucValid, 1, __ATOMIC_RELEASE);
+}
+
+void vTraceSetRecordHook(TraceRecordHook_t xHook) {
+    xTraceRecordHook = xHook;
+}
+
+uint32_t ulTraceGetDroppedCount(void) {
+    return __atomic_load_n(&ulTraceDropped, __ATOMIC_RELAXED);
 }
@@ -4,6 +4,32 @@
  *
  * This file defines the API for logging scheduler and task events with
  * tick-level precision for debugging and validation purposes.
+ *
+ * Events are stored as fixed-size binary records in a preallocated ring
+ * buffer. Recording never blocks and takes no mutex, so it can be used on the
+ * scheduler's critical timing path and from interrupts. Formatting and output
+ * are deferred to a low-priority drain task.
+ *
+ * The drain task writes either one line of text per record or, with
+ * TRACE_OUTPUT_BINARY, a compact binary stream that Tools/trace_decode.py
+ * turns into text, Chrome Trace Event JSON (Perfetto) or VCD. The binary
+ * stream is a sequence of packets whose first byte has bit 7 set; anything
+ * else on the UART, such as the text written by jobs, is 7-bit ASCII and is
+ * kept by the decoder as console output. Integers are unsigned LEB128
+ * varints (7 bits per byte, least significant first):
+ *
+ * - TRACE_PACKET_HEADER, 'T', 'L', TRACE_BINARY_VERSION, varint tick rate in
+ *   Hz. Starts the stream and follows every loss of output.
+ * - TRACE_PACKET_SYNC, varint tick. Sets the absolute tick of the next record.
+ * - TRACE_PACKET_NAME, varint task id, length byte, name bytes. Sent before
+ *   the first record of a task id and again whenever its name changes.
+ * - TRACE_PACKET_DROPPED, varint count. Records lost in the ring buffer.
+ * - TRACE_PACKET_EVENT + event, varint zigzag tick delta from the previous
+ *   record, varint task id + 1 (0 for TRACE_TASK_ID_SCHEDULER), varint
+ *   argument. Usually four bytes.
+ * - TRACE_PACKET_INSTANCE + event, the same fields followed by a varint
+ *   instance. Used instead of TRACE_PACKET_EVENT for the jobs of a multi-rate
+ *   task after its first instance.
  */
 
 #ifndef TRACE_H
@@ -11,35 +37,196 @@
 
 #include "FreeRTOS.h"
 
+// --- Public Configuration ---
+
+/**
+ * @brief Number of records the trace ring buffer can hold. Must be a power of two.
+ */
+#ifndef TRACE_BUFFER_LENGTH
+#define TRACE_BUFFER_LENGTH 256
+#endif
+
+/**
+ * @brief Number of task ids that can be given a name with vTraceSetTaskName().
+ *
+ * The timeline scheduler names every task slot, so this must be raised
+ * together with MAX_TASKS.
+ */
+#ifndef TRACE_MAX_TASK_NAMES
+#define TRACE_MAX_TASK_NAMES 16
+#endif
+
+/**
+ * @brief Priority of the drain task that formats and outputs trace records.
+ */
+#ifndef TRACE_DRAIN_TASK_PRIORITY
+#define TRACE_DRAIN_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+/**
+ * @brief Stack depth, in words, of the drain task.
+ */
+#ifndef TRACE_DRAIN_TASK_STACK_DEPTH
+#define TRACE_DRAIN_TASK_STACK_DEPTH (configMINIMAL_STACK_SIZE * 4)
+#endif
+
+/**
+ * @brief Period at which the drain task empties the ring buffer.
+ */
+#ifndef TRACE_DRAIN_PERIOD_TICKS
+#define TRACE_DRAIN_PERIOD_TICKS pdMS_TO_TICKS(10)
+#endif
+
+/**
+ * @brief Set to 1 to output the binary stream described above instead of text.
+ */
+#ifndef TRACE_OUTPUT_BINARY
+#define TRACE_OUTPUT_BINARY 0
+#endif
+
+/**
+ * @brief Bytes of binary output the drain task gathers before each UART write.
+ *
+ * The UART drops a write that does not fit as a whole, so this must be well
+ * below UART_TX_BUFFER_SIZE.
+ */
+#ifndef TRACE_BINARY_BATCH_BYTES
+#define TRACE_BINARY_BATCH_BYTES 64
+#endif
+
+#if (TRACE_BUFFER_LENGTH & (TRACE_BUFFER_LENGTH - 1)) != 0
+#error "TRACE_BUFFER_LENGTH must be a power of two"
+#endif
+
+/**
+ * @brief Task id used for events emitted by the scheduler itself.
+ */
+#define TRACE_TASK_ID_SCHEDULER 0xFFFFU
+
+/**
+ * @brief Version of the binary stream, raised on any incompatible change.
+ */
+#define TRACE_BINARY_VERSION 2U
+
+/**
+ * @brief First bytes of the binary packets.
+ */
+#define TRACE_PACKET_EVENT    0x80U /**< Plus the TraceEvent_t; events must stay below 0x20. */
+#define TRACE_PACKET_INSTANCE 0xA0U /**< Plus the TraceEvent_t, for records with an instance. */
+#define TRACE_PACKET_SYNC     0xE0U
+#define TRACE_PACKET_HEADER   0xE1U
+#define TRACE_PACKET_NAME     0xE2U
+#define TRACE_PACKET_DROPPED  0xE3U
+
+/**
+ * @brief Reasons carried by TRACE_EVENT_RELEASE_SKIPPED.
+ *
+ * The first two are overruns: the release could not start on time.
+ */
+#define TRACE_SKIP_BUSY   0U /**< The previous HRT job still owned the CPU, or the task could not be created. */
+#define TRACE_SKIP_LATE   1U /**< The scheduler reached the release only after its window had closed. */
+#define TRACE_SKIP_POLICY 2U /**< Skipped on purpose by the TIMELINE_MISS_SKIP policy. */
+
 /**
  * @brief Enumeration of events that can be logged by the trace system.
  */
 typedef enum {
     TRACE_EVENT_MAJOR_FRAME_START,
-    TRACE_EVENT_TASK_SPAWN,
+    TRACE_EVENT_TASK_SPAWN,      /**< A job was released; the argument is 1 if it runs the degraded handler. */
     TRACE_EVENT_TASK_COMPLETE,
     TRACE_EVENT_DEADLINE_MISS,
     TRACE_EVENT_TASK_CREATE_FAILED,
     TRACE_EVENT_IDLE_START,
     TRACE_EVENT_IDLE_END,
+    TRACE_EVENT_SUBFRAME_START,
+    TRACE_EVENT_RELEASE_SKIPPED, /**< A release did not start; the argument is one of the TRACE_SKIP_ reasons. */
+    TRACE_EVENT_FRAME_OVERRUN,
+    TRACE_EVENT_SRT_INCOMPLETE,
+    TRACE_EVENT_SWITCH_REQUEST,  /**< A schedule switch was requested; the argument is the schedule id. */
+    TRACE_EVENT_SCHEDULE_SWITCH, /**< A schedule switch took effect; the argument is the ticks since the request. */
+    TRACE_EVENT_STACK_OVERFLOW,  /**< The kernel detected a stack overflow in a managed task. */
+    TRACE_EVENT_ABORT_REQUEST,   /**< A running HRT job was asked to stop before its deadline. */
+    TRACE_EVENT_JOB_ABORTED,     /**< A job returned after an abort request; the argument is the ticks it took. */
+    TRACE_EVENT_JOB_RECLAIMED,   /**< A terminated job was deleted and its resources released; the argument is
+                                      the cycles since it was terminated, or 0 without TIMELINE_ENABLE_STATS. */
+    TRACE_EVENT_STATE_RESET,     /**< The registered state blocks were restored; the argument is the cycles it
+                                      took, or 0 without TIMELINE_ENABLE_STATS. */
 } TraceEvent_t;
 
+/**
+ * @brief A single trace record as stored in the ring buffer.
+ */
+typedef struct {
+    uint32_t ulTick;         /**< Tick count at which the event occurred. */
+    uint16_t usTaskId;       /**< Id of the task the event refers to, or TRACE_TASK_ID_SCHEDULER. */
+    uint8_t ucEvent;         /**< One of TraceEvent_t. */
+    volatile uint8_t ucValid;/**< Set once the record is fully written; internal to the ring buffer. */
+    uint32_t ulArg;          /**< Event-specific argument. */
+    uint8_t ucInstance;      /**< Instance of a multi-rate task whose job the event refers to, 0 otherwise. */
+} TraceRecord_t;
+
+/**
+ * @brief Function called synchronously for every logged event.
+ *
+ * Runs in the context of the vTraceLog() caller, which may be the scheduler
+ * task or an ISR, so it must be short and must not block.
+ */
+typedef void (*TraceRecordHook_t)(const TraceRecord_t *pxRecord);
+
 /**
  * @brief Initializes the tracing system.
  *
- * Must be called before any other trace function.
+ * Must be called before any other trace function. Creates the drain task.
  */
 void vTraceInit(void);
 
+/**
+ * @brief Associates a name with a task id for the formatted output.
+ *
+ * In the binary stream the full name is sent, up to 255 characters.
+ * @param usTaskId The task id used in vTraceLog() calls.
+ * @param pcName The name to print. The string is not copied.
+ */
+void vTraceSetTaskName(uint16_t usTaskId, const char *pcName);
+
 /**
  * @brief Logs a scheduler event.
  *
- * This function is thread-safe and can be called from any task.
+ * Stores a binary record in the ring buffer. The call never blocks and takes
+ * no lock, so it can be made from any task and from interrupts; from an ISR
+ * the tick must be read with xTaskGetTickCountFromISR(). When the buffer is
+ * full the record is dropped and counted.
  *
  * @param xEvent The type of event to log.
- * @param pcTaskName The name of the task associated with the event.
+ * @param usTaskId The id of the task associated with the event.
  * @param xTick The tick count at which the event occurred.
+ * @param ulArg Event-specific argument, 0 if unused.
+ */
+void vTraceLog(TraceEvent_t xEvent, uint16_t usTaskId, TickType_t xTick, uint32_t ulArg);
+
+/**
+ * @brief Logs an event of one instance of a multi-rate task.
+ *
+ * Same as vTraceLog(), which logs instance 0.
+ *
+ * @param ucInstance Instance of the task whose job the event refers to.
+ */
+void vTraceLogInstance(TraceEvent_t xEvent, uint16_t usTaskId, uint8_t ucInstance, TickType_t xTick, uint32_t ulArg);
+
+/**
+ * @brief Installs a hook that sees every event as it is logged.
+ *
+ * Intended for test harnesses that check the event sequence. The hook is
+ * called before the record is stored, so it also sees records that are
+ * dropped because the buffer is full.
+ *
+ * @param xHook The hook, or NULL to remove it.
+ */
+void vTraceSetRecordHook(TraceRecordHook_t xHook);
+
+/**
+ * @brief Returns the number of records dropped because the buffer was full.
  */
-void vTraceLog(TraceEvent_t xEvent, const char *pcTaskName, TickType_t xTick);
+uint32_t ulTraceGetDroppedCount(void);
 
 #endif // TRACE_H
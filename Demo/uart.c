@@ -1,14 +1,119 @@
 #include "uart.h"
+#include <string.h>
+
+#if ( UART_TX_BUFFER_SIZE & ( UART_TX_BUFFER_SIZE - 1UL ) ) != 0
+#error "UART_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+/* NVIC registers used to enable and prioritise the transmit interrupt. */
+#define NVIC_ISER0                            ( *( ( volatile uint32_t * ) 0xE000E100UL ) )
+#define NVIC_IPR_BASE                         ( ( volatile uint8_t * ) 0xE000E400UL )
+
+/* The transmit interrupt does not use the FreeRTOS API, but it must be masked
+ * by portSET_INTERRUPT_MASK_FROM_ISR(), so it runs at the lowest priority. */
+#define UART_TX_IRQ_PRIORITY                  ( 255U )
+
+/* Transmit ring buffer. The head is advanced by writers with the interrupt
+ * masked; the tail is only advanced by the transmit interrupt. */
+static uint8_t ucTxBuffer[ UART_TX_BUFFER_SIZE ];
+static volatile uint32_t ulTxHead = 0;
+static volatile uint32_t ulTxTail = 0;
+static volatile BaseType_t xTxActive = pdFALSE;
+static volatile uint32_t ulTxDropped = 0;
+
+/* Sends the next buffered byte, or marks the transmitter idle if none is
+ * left. Must be called with interrupts masked by
+ * portSET_INTERRUPT_MASK_FROM_ISR(), as every caller may be preempted by a
+ * writer. */
+static void prvSendNextByte( void )
+{
+    if( ulTxTail != ulTxHead )
+    {
+        UART0_DATA = ucTxBuffer[ ulTxTail & ( UART_TX_BUFFER_SIZE - 1UL ) ];
+        ulTxTail++;
+        xTxActive = pdTRUE;
+    }
+    else
+    {
+        xTxActive = pdFALSE;
+    }
+}
 
 void UART_init( void )
 {
     UART0_BAUDDIV = 16;
-    UART0_CTRL = 1;
+    UART0_CTRL = UART_CTRL_TX_EN | UART_CTRL_TX_INT_EN;
+
+    NVIC_IPR_BASE[ UART0_TX_IRQn ] = UART_TX_IRQ_PRIORITY;
+    NVIC_ISER0 = ( 1UL << UART0_TX_IRQn );
 }
 
 void UART_printf(const char *s) {
     while(*s != '\0') {
+        while( ( UART0_STATE & UART_STATE_TX_FULL ) != 0 ) {
+        }
         UART0_DATA = (unsigned int)(*s);
         s++;
     }
 }
+
+size_t UART_write( const char *pcData, size_t xLength )
+{
+    UBaseType_t uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t ulFree = UART_TX_BUFFER_SIZE - ( ulTxHead - ulTxTail );
+
+    if( xLength > ulFree )
+    {
+        /* Drop the whole message rather than emit a truncated line. */
+        ulTxDropped += xLength;
+        xLength = 0;
+    }
+    else
+    {
+        uint32_t ulOffset = ulTxHead & ( UART_TX_BUFFER_SIZE - 1UL );
+        size_t xFirst = UART_TX_BUFFER_SIZE - ulOffset;
+
+        if( xFirst > xLength )
+        {
+            xFirst = xLength;
+        }
+
+        memcpy( &ucTxBuffer[ ulOffset ], pcData, xFirst );
+        memcpy( &ucTxBuffer[ 0 ], pcData + xFirst, xLength - xFirst );
+        ulTxHead += xLength;
+
+        /* An idle transmitter raises no interrupt; send the first byte here
+         * and let the interrupt drain the rest. */
+        if( xTxActive == pdFALSE )
+        {
+            prvSendNextByte();
+        }
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+
+    return xLength;
+}
+
+void uart_puts( const char *s )
+{
+    ( void ) UART_write( s, strlen( s ) );
+}
+
+uint32_t UART_getDroppedBytes( void )
+{
+    return ulTxDropped;
+}
+
+void UART0_TxHandler( void )
+{
+    /* Any other interrupt may preempt this one and call UART_write(). With
+     * the mask, the writer cannot see xTxActive set after the ring was found
+     * empty, and leave its bytes waiting for the next write. */
+    UBaseType_t uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    UART0_INTSTATUS = UART_INTSTATUS_TX;
+    prvSendNextByte();
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+}
@@ -7,9 +7,42 @@
 #define UART0_DATA                            ( *( ( ( volatile uint32_t * ) ( UART0_ADDRESS + 0UL ) ) ) )
 #define UART0_STATE                           ( *( ( ( volatile uint32_t * ) ( UART0_ADDRESS + 4UL ) ) ) )
 #define UART0_CTRL                            ( *( ( ( volatile uint32_t * ) ( UART0_ADDRESS + 8UL ) ) ) )
+#define UART0_INTSTATUS                       ( *( ( ( volatile uint32_t * ) ( UART0_ADDRESS + 12UL ) ) ) )
 #define UART0_BAUDDIV                         ( *( ( ( volatile uint32_t * ) ( UART0_ADDRESS + 16UL ) ) ) )
 
+/* CMSDK APB UART register bits. */
+#define UART_STATE_TX_FULL                    ( 1UL << 0 )
+#define UART_CTRL_TX_EN                       ( 1UL << 0 )
+#define UART_CTRL_TX_INT_EN                   ( 1UL << 2 )
+#define UART_INTSTATUS_TX                     ( 1UL << 0 )
+
+/* UART0 transmit interrupt on the MPS2 AN385. */
+#define UART0_TX_IRQn                         ( 1UL )
+
+/* Size of the transmit ring buffer in bytes. Must be a power of two. */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE                   ( 1024UL )
+#endif
+
 void UART_init(void);
+
+/* Writes a string synchronously by polling the transmitter. Only meant for
+ * contexts where interrupts cannot be relied upon, such as fault handlers. */
 void UART_printf(const char *s);
 
+/* Queues bytes for interrupt-driven transmission. Never blocks and can be
+ * called from tasks and ISRs. If the data does not fit in the free space of
+ * the buffer it is dropped as a whole and counted. Returns the number of
+ * bytes queued. */
+size_t UART_write(const char *pcData, size_t xLength);
+
+/* Queues a NUL-terminated string, see UART_write(). */
+void uart_puts(const char *s);
+
+/* Returns the number of bytes dropped because the transmit buffer was full. */
+uint32_t UART_getDroppedBytes(void);
+
+/* UART0 transmit interrupt handler, installed in the vector table. */
+void UART0_TxHandler(void);
+
 #endif
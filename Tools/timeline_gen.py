@@ -0,0 +1,495 @@
+#!/usr/bin/env python3
+"""Offline schedulability analyser and generator for the timeline scheduler.
+
+Reads a schedule description in JSON, checks it against the rules enforced by
+xTimelineSchedulerInit() and the timing model of the scheduler, and emits a
+ready-to-compile TimelineConfig_t table and an optional FreeRTOS skeleton.
+
+Schedule description::
+
+    {
+      "tick_rate_hz": 1000,          # configTICK_RATE_HZ
+      "major_frame_ms": 100,         # MAJOR_FRAME_DURATION_TICKS
+      "subframe_ms": 50,             # SUBFRAME_DURATION_TICKS
+      "max_tasks": 16,               # MAX_TASKS
+      "max_name_len": 12,            # configMAX_TASK_NAME_LEN
+      "min_stack_words": 80,         # configMINIMAL_STACK_SIZE
+      "default_stack_words": 80,     # TIMELINE_TASK_STACK_DEPTH
+      "stack_arena_words": 1280,     # TIMELINE_STACK_ARENA_WORDS
+      "max_events": 50,              # TIMELINE_MAX_EVENTS
+      "scheduler_overhead_percent": 2,
+      "tasks": [
+        {"name": "HRT1", "type": "hard", "function": "vTask_HRT1",
+         "start_ms": 10, "end_ms": 40, "subframe": 0, "wcet_ms": 20},
+        {"name": "Ctrl", "type": "hard", "function": "vTask_Ctrl",
+         "start_ms": 2, "end_ms": 6, "period_ms": 50, "wcet_ms": 1},
+        {"name": "SRT1", "type": "soft", "function": "vTask_SRT1", "wcet_ms": 5,
+         "stack_words": 160}
+      ]
+    }
+
+Every time may be given in milliseconds (``*_ms``, converted like
+pdMS_TO_TICKS()) or in ticks (``*_ticks``). ``wcet`` is optional; without it an
+HRT job is assumed to use its whole window and the SRT load is unknown.
+``stack_words`` is optional too and defaults to ``default_stack_words``; the
+stacks of all tasks must fit in ``stack_arena_words``.
+
+An HRT task with a ``period`` is multi-rate: its window is that of the first
+instance and is repeated every period across the major frame. The period must
+divide the major frame, the window must end within it, and every instance
+must lie inside the sub-frame it starts in; ``subframe`` is ignored. Each
+instance takes three entries of the event table, whose size defaults to
+TIMELINE_MAX_EVENTS for ``max_tasks`` tasks.
+
+Usage::
+
+    timeline_gen.py schedule.json                      # report only
+    timeline_gen.py schedule.json --table table.c      # + TimelineConfig_t table
+    timeline_gen.py schedule.json --skeleton main.c    # + complete FreeRTOS main.c
+    timeline_gen.py --batch candidates.jsonl           # one schedule per line
+
+The exit status is 0 when every schedule is valid, 1 when at least one has
+errors and 2 on bad usage. The analysis is O(n log n) in the number of releases
+and needs only the standard library, so batch mode checks thousands of
+candidate layouts per second.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+DEFAULTS = {
+    "tick_rate_hz": 1000,
+    "major_frame_ms": 100,
+    "subframe_ms": 50,
+    "max_tasks": 16,
+    "max_name_len": 12,
+    "min_stack_words": 80,
+    "default_stack_words": 80,
+    "stack_arena_words": None,
+    "max_events": None,
+    "scheduler_overhead_percent": 0,
+}
+
+C_IDENTIFIER = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+
+class ScheduleError(Exception):
+    """Raised when a schedule description cannot be parsed at all."""
+
+
+# --- Parsing ---
+
+
+def ms_to_ticks(ms, tick_rate_hz):
+    """Converts milliseconds to ticks the way pdMS_TO_TICKS() does."""
+    return (int(ms) * tick_rate_hz) // 1000
+
+
+def read_time(entry, key, tick_rate_hz, required=True):
+    """Returns (ticks, C expression) for ``key_ms`` or ``key_ticks``, or (None, None)."""
+    if key + "_ticks" in entry:
+        ticks = int(entry[key + "_ticks"])
+        return ticks, str(ticks)
+    if key + "_ms" in entry:
+        ms = entry[key + "_ms"]
+        return ms_to_ticks(ms, tick_rate_hz), "pdMS_TO_TICKS(%d)" % int(ms)
+    if required:
+        raise ScheduleError("task '%s' has no %s_ms or %s_ticks" % (entry.get("name", "?"), key, key))
+    return None, None
+
+
+def parse_schedule(data):
+    """Normalises a decoded JSON schedule; all times become ticks."""
+    if not isinstance(data, dict) or not isinstance(data.get("tasks"), list):
+        raise ScheduleError("a schedule must be an object with a 'tasks' list")
+
+    sched = dict(DEFAULTS)
+    sched.update({k: v for k, v in data.items() if k != "tasks"})
+    rate = int(sched["tick_rate_hz"])
+    sched["major_ticks"] = read_time(sched, "major_frame", rate)[0]
+    sched["subframe_ticks"] = read_time(sched, "subframe", rate)[0]
+
+    tasks = []
+    for index, entry in enumerate(data["tasks"]):
+        kind = str(entry.get("type", "")).lower()
+        if kind not in ("hard", "soft"):
+            raise ScheduleError("task %d: type must be 'hard' or 'soft'" % index)
+        task = {
+            "index": index,
+            "name": str(entry.get("name", "Task%d" % index)),
+            "function": str(entry.get("function", "vTask_%s" % entry.get("name", index))),
+            "hard": kind == "hard",
+            "start": 0,
+            "end": 0,
+            "start_expr": "0",
+            "end_expr": "0",
+            "subframe": int(entry.get("subframe", 0)),
+        }
+        if task["hard"]:
+            task["start"], task["start_expr"] = read_time(entry, "start", rate)
+            task["end"], task["end_expr"] = read_time(entry, "end", rate)
+        task["period"], task["period_expr"] = read_time(entry, "period", rate, required=False)
+        if task["period"] is None:
+            task["period"], task["period_expr"] = 0, "0"
+        task["wcet"] = read_time(entry, "wcet", rate, required=False)[0]
+        task["stack_words"] = int(entry.get("stack_words", 0))
+        tasks.append(task)
+
+    sched["tasks"] = tasks
+    return sched
+
+
+# --- Analysis ---
+
+
+def analyse(sched):
+    """Checks a parsed schedule and computes its timing figures.
+
+    Returns a report dict with 'errors', 'warnings', 'subframes' (per
+    sub-frame reserved/demand/gaps) and 'srt' (capacity estimate).
+    """
+    errors = []
+    warnings = []
+    major = sched["major_ticks"]
+    sub = sched["subframe_ticks"]
+    tasks = sched["tasks"]
+
+    if sub <= 0 or major <= 0 or major % sub != 0:
+        errors.append("major frame (%d ticks) is not a whole number of sub-frames (%d ticks)" % (major, sub))
+        return {"errors": errors, "warnings": warnings, "subframes": [], "srt": None}
+    n_sub = major // sub
+
+    if len(tasks) > sched["max_tasks"]:
+        errors.append("%d tasks exceed MAX_TASKS (%d)" % (len(tasks), sched["max_tasks"]))
+
+    seen = {}
+    for t in tasks:
+        if not C_IDENTIFIER.match(t["function"]):
+            errors.append("task '%s': '%s' is not a C identifier" % (t["name"], t["function"]))
+        if len(t["name"]) >= sched["max_name_len"]:
+            warnings.append("task '%s': name is truncated to %d characters by FreeRTOS"
+                            % (t["name"], sched["max_name_len"] - 1))
+        if t["name"] in seen:
+            warnings.append("task '%s' is declared more than once" % t["name"])
+        seen[t["name"]] = True
+
+    # Same resolution as prvStackDepth(): 0 is the default, small depths are raised
+    arena = sched["stack_arena_words"]
+    if arena is None:
+        arena = sched["max_tasks"] * sched["default_stack_words"]
+    stack_total = sum(max(t["stack_words"] or sched["default_stack_words"], sched["min_stack_words"]) for t in tasks)
+    if stack_total > arena:
+        errors.append("task stacks need %d words, more than the %d-word stack arena" % (stack_total, arena))
+
+    for t in tasks:
+        if t["period"] and not t["hard"]:
+            errors.append("task '%s': only HRT tasks can have a period" % t["name"])
+
+    # A multi-rate task is checked instance by instance, like the event table
+    # the scheduler builds for it; each instance is a window of its own below
+    hard = []
+    for t in (t for t in tasks if t["hard"]):
+        period = t["period"]
+        count = 1
+        if period:
+            if period < 0 or major % period != 0:
+                errors.append("task '%s': period %d does not divide the major frame (%d)" % (t["name"], period, major))
+                continue
+            count = major // period
+            if count > 255:
+                errors.append("task '%s': %d instances per frame, at most 255" % (t["name"], count))
+                continue
+            if t["end"] > period:
+                errors.append("task '%s': window [%d, %d) ends after its period of %d ticks"
+                              % (t["name"], t["start"], t["end"], period))
+        for k in range(count):
+            inst = dict(t)
+            inst["start"] = t["start"] + k * period
+            inst["end"] = t["end"] + k * period
+            if period:
+                inst["name"] = "%s#%d" % (t["name"], k)
+                inst["subframe"] = inst["start"] // sub
+            hard.append(inst)
+
+    for t in hard:
+        start, end, sf = t["start"], t["end"], t["subframe"]
+        if start >= end:
+            errors.append("task '%s': empty window [%d, %d)" % (t["name"], start, end))
+        if end > major:
+            errors.append("task '%s': ends at %d, past the major frame (%d)" % (t["name"], end, major))
+        if not 0 <= sf < n_sub:
+            errors.append("task '%s': sub-frame %d does not exist (0..%d)" % (t["name"], sf, n_sub - 1))
+        elif start < sf * sub or end > (sf + 1) * sub:
+            errors.append("task '%s': window [%d, %d) straddles sub-frame %d [%d, %d)"
+                          % (t["name"], start, end, sf, sf * sub, (sf + 1) * sub))
+        if t["wcet"] is not None and t["wcet"] > end - start:
+            errors.append("task '%s': WCET %d exceeds its window of %d ticks" % (t["name"], t["wcet"], end - start))
+
+    # Same bound as prvBuildTable(): a release, a deadline and an abort request per instance
+    max_events = sched["max_events"]
+    if max_events is None:
+        max_events = 3 * sched["max_tasks"] + n_sub
+    if 3 * len(hard) + n_sub > max_events:
+        errors.append("the event table needs %d entries, more than TIMELINE_MAX_EVENTS (%d)"
+                      % (3 * len(hard) + n_sub, max_events))
+
+    # A release that finds the previous HRT job still running is skipped, so
+    # overlapping windows can silently lose jobs.
+    ordered = sorted(hard, key=lambda t: (t["start"], t["end"]))
+    owner = None
+    for t in ordered:
+        if owner is not None and t["start"] < owner["end"]:
+            errors.append("tasks '%s' [%d, %d) and '%s' [%d, %d) overlap"
+                          % (owner["name"], owner["start"], owner["end"], t["name"], t["start"], t["end"]))
+        if owner is None or t["end"] > owner["end"]:
+            owner = t
+
+    subframes = []
+    hrt_demand_total = 0
+    for sf in range(n_sub):
+        lo, hi = sf * sub, (sf + 1) * sub
+        windows = sorted(((max(t["start"], lo), min(t["end"], hi), t) for t in hard
+                          if t["start"] < t["end"] and t["start"] < hi and t["end"] > lo), key=lambda w: w[:2])
+        reserved = 0
+        demand = 0
+        gaps = []
+        cursor = lo
+        for start, end, t in windows:
+            if start > cursor:
+                gaps.append((cursor, start))
+            if end > cursor:
+                reserved += end - max(start, cursor)
+                cursor = end
+            if t["wcet"] is None:
+                demand += end - start
+            else:
+                # A window straddling sub-frames shares its WCET pro rata
+                demand += t["wcet"] * (end - start) / float(t["end"] - t["start"])
+        if cursor < hi:
+            gaps.append((cursor, hi))
+        hrt_demand_total += demand
+        subframes.append({"id": sf, "length": sub, "reserved": reserved, "demand": demand, "gaps": gaps})
+
+    # SRT jobs run in every tick left over by HRT jobs and the scheduler,
+    # including the unused tail of HRT windows.
+    overhead = (major * float(sched["scheduler_overhead_percent"])) / 100.0
+    capacity = max(0.0, major - hrt_demand_total - overhead)
+    soft = [t for t in tasks if not t["hard"]]
+    known = all(t["wcet"] is not None for t in soft)
+    load = sum(t["wcet"] for t in soft if t["wcet"] is not None)
+    if known and load > capacity:
+        warnings.append("SRT load of %d ticks exceeds the %.1f ticks left per frame; the last SRT jobs will not complete"
+                        % (load, capacity))
+
+    return {
+        "errors": errors,
+        "warnings": warnings,
+        "subframes": subframes,
+        "srt": {"count": len(soft), "capacity": capacity, "load": load if known else None},
+    }
+
+
+# --- Output ---
+
+
+def format_report(sched, report):
+    """Returns the human-readable report of one schedule."""
+    lines = []
+    lines.append("Major frame %d ticks, %d sub-frames of %d ticks, %d tasks"
+                 % (sched["major_ticks"], len(report["subframes"]), sched["subframe_ticks"], len(sched["tasks"])))
+    for sf in report["subframes"]:
+        gaps = ", ".join("[%d, %d)" % g for g in sf["gaps"]) or "none"
+        lines.append("  sub-frame %d: reserved %5.1f%%  HRT demand %5.1f%%  gaps %s"
+                     % (sf["id"], 100.0 * sf["reserved"] / sf["length"], 100.0 * sf["demand"] / sf["length"], gaps))
+    srt = report["srt"]
+    if srt is not None:
+        load = "unknown (missing wcet)" if srt["load"] is None else "%d ticks" % srt["load"]
+        lines.append("  SRT: %d tasks, capacity %.1f ticks per frame, load %s" % (srt["count"], srt["capacity"], load))
+    for w in report["warnings"]:
+        lines.append("warning: " + w)
+    for e in report["errors"]:
+        lines.append("error: " + e)
+    lines.append("Schedule is %s" % ("INVALID" if report["errors"] else "valid"))
+    return "\n".join(lines)
+
+
+def format_summary(index, report):
+    """Returns the one-line batch summary of one schedule."""
+    peak = max((sf["demand"] / float(sf["length"]) for sf in report["subframes"]), default=0.0)
+    srt = report["srt"]
+    slack = "-" if srt is None or srt["load"] is None else "%.1f" % (srt["capacity"] - srt["load"])
+    return "%d %s errors=%d warnings=%d peak_hrt=%.1f%% srt_slack=%s" % (
+        index, "fail" if report["errors"] else "ok", len(report["errors"]), len(report["warnings"]), 100.0 * peak, slack)
+
+
+def emit_table(sched, table_name, config_name, prototypes=True):
+    """Returns the C source of the TimelineTaskConfig_t table."""
+    out = []
+    if prototypes:
+        out.append('#include "timeline_scheduler.h"')
+        out.append("")
+        for name in sorted(set(t["function"] for t in sched["tasks"])):
+            out.append("void %s(void *pvParameters);" % name)
+        out.append("")
+    out.append("// The layout below was checked against these frame parameters")
+    out.append('_Static_assert(MAJOR_FRAME_DURATION_TICKS == %d, "major frame differs from the analysed schedule");'
+               % sched["major_ticks"])
+    out.append('_Static_assert(SUBFRAME_DURATION_TICKS == %d, "sub-frame differs from the analysed schedule");'
+               % sched["subframe_ticks"])
+    out.append('_Static_assert(MAX_TASKS >= %d, "too many tasks for MAX_TASKS");' % len(sched["tasks"]))
+    if any(t["period"] for t in sched["tasks"]):
+        events = 3 * sum(sched["major_ticks"] // t["period"] if t["period"] else 1 for t in sched["tasks"] if t["hard"])
+        events += sched["major_ticks"] // sched["subframe_ticks"]
+        out.append('_Static_assert(TIMELINE_MAX_EVENTS >= %d, "event table too small for the multi-rate tasks");'
+                   % events)
+    out.append("")
+    out.append("const TimelineTaskConfig_t %s[] = {" % table_name)
+    for t in sched["tasks"]:
+        kind = "TASK_TYPE_HARD_RT" if t["hard"] else "TASK_TYPE_SOFT_RT"
+        head = '.pvTaskCode = %s, .pcName = "%s", .xTaskType = %s' % (t["function"], t["name"], kind)
+        # Windows are analysed in ticks and misses keep the default policy, so the
+        # fields left out stay 0; a multi-rate task names no sub-frame
+        fields = []
+        if t["hard"]:
+            fields += [".ulStartTimeTicks = %s" % t["start_expr"], ".ulEndTimeTicks = %s" % t["end_expr"]]
+            if not t["period"]:
+                fields.append(".ulSubframeId = %d" % t["subframe"])
+        if t["stack_words"]:
+            fields.append(".ulStackDepth = %d" % t["stack_words"])
+        if t["period"]:
+            fields.append(".ulPeriodTicks = %s" % t["period_expr"])
+        if fields:
+            out.append("    { %s," % head)
+            out.append("      %s }," % ", ".join(fields))
+        else:
+            out.append("    { %s }," % head)
+    out.append("};")
+    out.append("")
+    out.append("const TimelineConfig_t %s = {" % config_name)
+    out.append("    .pxTasks = %s," % table_name)
+    out.append("    .uxNumTasks = sizeof(%s) / sizeof(TimelineTaskConfig_t)" % table_name)
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def emit_skeleton(sched, table_name, config_name):
+    """Returns a complete main.c with task stubs, hooks and the table."""
+    out = ['#include "FreeRTOS.h"', '#include "task.h"', '#include "uart.h"', '#include "timeline_scheduler.h"', ""]
+    out.append("// --- Task Implementations ---")
+    out.append("")
+    for name in sorted(set(t["function"] for t in sched["tasks"])):
+        out.append("void %s(void *pvParameters) {" % name)
+        out.append("    (void)pvParameters;")
+        out.append('    uart_puts("%s: Running\\r\\n");' % name)
+        out.append("    // Returning signals completion; the scheduler reclaims the task")
+        out.append("}")
+        out.append("")
+    out.append("")
+    out.append("// --- FreeRTOS Hooks ---")
+    out.append("")
+    out.append("void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,")
+    out.append("                                   StackType_t **ppxIdleTaskStackBuffer,")
+    out.append("                                   uint32_t *pulIdleTaskStackSize) {")
+    out.append("    static StaticTask_t xIdleTaskTCB;")
+    out.append("    static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];")
+    out.append("")
+    out.append("    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;")
+    out.append("    *ppxIdleTaskStackBuffer = uxIdleTaskStack;")
+    out.append("    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;")
+    out.append("}")
+    out.append("")
+    out.append("void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {")
+    out.append("    vTimelineSchedulerReportStackOverflow(xTask, pcTaskName);")
+    out.append("    taskDISABLE_INTERRUPTS();")
+    out.append("    configASSERT(pdFALSE);")
+    out.append("}")
+    out.append("")
+    out.append("void vApplicationTickHook(void) {")
+    out.append("    vTimelineSchedulerTickHook();")
+    out.append("}")
+    out.append("")
+    out.append("")
+    out.append("// --- Scheduler Configuration ---")
+    out.append("")
+    out.append(emit_table(sched, table_name, config_name, prototypes=False))
+    out.append("")
+    out.append("int main(void) {")
+    out.append("    UART_init();")
+    out.append("")
+    out.append("    if (xTimelineSchedulerInit(&%s) != pdPASS) {" % config_name)
+    out.append('        uart_puts("ERROR: Failed to initialize timeline scheduler.\\r\\n");')
+    out.append("        for (;;);")
+    out.append("    }")
+    out.append("")
+    out.append("    vTaskStartScheduler();")
+    out.append("    for (;;);")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+# --- Command Line ---
+
+
+def run_batch(path):
+    """Analyses one schedule per line and prints a summary per schedule."""
+    failed = False
+    stream = sys.stdin if path == "-" else open(path)
+    with stream:
+        for index, line in enumerate(stream):
+            if not line.strip():
+                continue
+            try:
+                report = analyse(parse_schedule(json.loads(line)))
+            except (ScheduleError, ValueError, TypeError) as exc:
+                print("%d fail parse: %s" % (index, exc))
+                failed = True
+                continue
+            failed = failed or bool(report["errors"])
+            print(format_summary(index, report))
+    return 1 if failed else 0
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Check a timeline schedule and generate its C configuration.")
+    parser.add_argument("schedule", nargs="?", help="schedule description (JSON)")
+    parser.add_argument("--batch", metavar="FILE", help="analyse one JSON schedule per line ('-' for stdin)")
+    parser.add_argument("--table", metavar="FILE", help="write the TimelineConfig_t table to FILE")
+    parser.add_argument("--skeleton", metavar="FILE", help="write a complete FreeRTOS main.c to FILE")
+    parser.add_argument("--table-name", default="xMyTasks", help="name of the task array (default: xMyTasks)")
+    parser.add_argument("--config-name", default="xMyTimeline", help="name of the TimelineConfig_t (default: xMyTimeline)")
+    parser.add_argument("--force", action="store_true", help="generate code even if the schedule has errors")
+    args = parser.parse_args(argv)
+
+    if args.batch:
+        return run_batch(args.batch)
+    if not args.schedule:
+        parser.error("a schedule or --batch is required")
+
+    try:
+        with open(args.schedule) as f:
+            sched = parse_schedule(json.load(f))
+    except (OSError, ValueError, ScheduleError) as exc:
+        print("error: %s" % exc, file=sys.stderr)
+        return 2
+
+    report = analyse(sched)
+    print(format_report(sched, report))
+
+    if report["errors"] and not args.force:
+        if args.table or args.skeleton:
+            print("No code generated; use --force to override.", file=sys.stderr)
+        return 1
+
+    if args.table:
+        with open(args.table, "w") as f:
+            f.write(emit_table(sched, args.table_name, args.config_name))
+    if args.skeleton:
+        with open(args.skeleton, "w") as f:
+            f.write(emit_skeleton(sched, args.table_name, args.config_name))
+    return 1 if report["errors"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,678 @@
+#!/usr/bin/env python3
+"""Decoder and converter for the binary trace stream of the timeline scheduler.
+
+Reads a UART capture of a firmware built with TRACE_OUTPUT_BINARY=1 (the
+packet format is described in Demo/trace.h) and writes any of:
+
+- a human-readable log in the style of the assignment::
+
+      [ 21 ms ] Task_A start
+      [ 26 ms ] Task_A end
+      [ 40 ms ] Task_B start
+      [ 47 ms ] Task_B deadline miss -> terminated
+
+- Chrome Trace Event JSON, which loads in https://ui.perfetto.dev and
+  chrome://tracing: one lane per task with a slice per job, a lane with the
+  major and sub-frame slices, a lane with the idle periods and one with the
+  text written by the jobs; kills, skips and overruns are instant markers;
+  the jobs of a multi-rate task are named after their instance, as in
+  ``Ctrl#3``;
+
+- a VCD file for GTKWave and other waveform viewers: one wire per task that
+  is high while a job runs, a kill event per task, the current sub-frame,
+  a major frame event and an idle wire.
+
+The text written by jobs on the same UART is 7-bit ASCII and cannot be
+mistaken for a packet, so it is kept as console output.
+
+Usage::
+
+    trace_decode.py capture.bin                       # text log to stdout
+    trace_decode.py capture.bin --chrome trace.json   # Perfetto / chrome://tracing
+    trace_decode.py capture.bin --vcd trace.vcd --text trace.txt --summary
+
+All outputs are produced in a single streaming pass over the capture, so a
+multi-hour capture is converted in seconds. The exit status is 0 on success,
+1 when the stream is damaged or of an unknown version and 2 on bad usage.
+"""
+
+import argparse
+import json
+import shutil
+import signal
+import sys
+import tempfile
+
+# Binary stream versions understood by this decoder (TRACE_BINARY_VERSION);
+# version 1 streams have no instance packets and decode the same way
+STREAM_VERSIONS = (1, 2)
+
+# Packet types (TRACE_PACKET_*)
+PACKET_EVENT = 0x80
+PACKET_INSTANCE = 0xA0
+PACKET_SYNC = 0xE0
+PACKET_HEADER = 0xE1
+PACKET_NAME = 0xE2
+PACKET_DROPPED = 0xE3
+
+# TraceEvent_t, in declaration order
+EVENTS = [
+    "MAJOR_FRAME_START",
+    "TASK_SPAWN",
+    "TASK_COMPLETE",
+    "DEADLINE_MISS",
+    "TASK_CREATE_FAILED",
+    "IDLE_START",
+    "IDLE_END",
+    "SUBFRAME_START",
+    "RELEASE_SKIPPED",
+    "FRAME_OVERRUN",
+    "SRT_INCOMPLETE",
+    "SWITCH_REQUEST",
+    "SCHEDULE_SWITCH",
+    "STACK_OVERFLOW",
+    "ABORT_REQUEST",
+    "JOB_ABORTED",
+    "JOB_RECLAIMED",
+    "STATE_RESET",
+]
+EV = {name: index for index, name in enumerate(EVENTS)}
+
+# TRACE_SKIP_* reasons of RELEASE_SKIPPED
+SKIP_REASONS = {0: "busy", 1: "late", 2: "policy"}
+
+# Decoded task id of TRACE_TASK_ID_SCHEDULER
+SCHEDULER = None
+
+# Events that end the running job of a task, with the way it ended
+JOB_ENDS = {
+    EV["TASK_COMPLETE"]: "complete",
+    EV["DEADLINE_MISS"]: "killed",
+    EV["JOB_ABORTED"]: "aborted",
+    EV["SRT_INCOMPLETE"]: "incomplete",
+}
+
+DEFAULT_TICK_RATE_HZ = 1000
+
+
+class StreamError(Exception):
+    """Raised when the capture cannot be decoded."""
+
+
+# --- Decoding ---
+
+
+def decode(data, sink):
+    """Decodes a capture and feeds it to ``sink``.
+
+    ``sink`` receives header(version, tick_rate_hz), name(task, name),
+    event(tick, task, event, arg, instance), dropped(tick, count) and
+    console(tick, text) calls, in stream order. Ticks are unwrapped to 64 bits. A packet cut
+    off by the end of the capture is ignored.
+    """
+    n = len(data)
+    i = 0
+    tick = 0
+    synced = False
+    line = bytearray()
+    on_event = sink.event
+    events = 0
+    first_tick = None
+    last_tick = 0
+
+    while i < n:
+        b = data[i]
+        if b < 0x80:
+            # Console text between packets
+            i += 1
+            if b == 0x0A:
+                sink.console(tick, line.decode("ascii", "replace").rstrip("\r"))
+                del line[:]
+            else:
+                line.append(b)
+            continue
+
+        try:
+            if b < PACKET_SYNC:
+                # Event: zigzag tick delta, task id + 1, argument and, for
+                # the later instances of a multi-rate task, the instance
+                j = i + 1
+                v = data[j]; j += 1
+                if v < 0x80:
+                    delta = v
+                else:
+                    delta = v & 0x7F; shift = 7
+                    while True:
+                        v = data[j]; j += 1
+                        delta |= (v & 0x7F) << shift
+                        if v < 0x80:
+                            break
+                        shift += 7
+                v = data[j]; j += 1
+                if v < 0x80:
+                    task = v
+                else:
+                    task = v & 0x7F; shift = 7
+                    while True:
+                        v = data[j]; j += 1
+                        task |= (v & 0x7F) << shift
+                        if v < 0x80:
+                            break
+                        shift += 7
+                v = data[j]; j += 1
+                if v < 0x80:
+                    arg = v
+                else:
+                    arg = v & 0x7F; shift = 7
+                    while True:
+                        v = data[j]; j += 1
+                        arg |= (v & 0x7F) << shift
+                        if v < 0x80:
+                            break
+                        shift += 7
+                if b < PACKET_INSTANCE:
+                    event = b - PACKET_EVENT
+                    instance = 0
+                else:
+                    event = b - PACKET_INSTANCE
+                    instance, j = read_varint(data, j)
+                i = j
+                if not synced:
+                    continue
+                tick += (delta >> 1) ^ -(delta & 1)
+                if first_tick is None:
+                    first_tick = tick
+                if tick > last_tick:
+                    last_tick = tick
+                events += 1
+                on_event(tick, task - 1 if task else SCHEDULER, event, arg, instance)
+            elif b == PACKET_SYNC:
+                value, i = read_varint(data, i + 1)
+                # The device tick is 32 bits; keep counting across wrap-arounds
+                base = tick - (tick & 0xFFFFFFFF) if synced else 0
+                candidate = base + value
+                if synced and candidate + (1 << 31) < tick:
+                    candidate += 1 << 32
+                tick = candidate
+                synced = True
+            elif b == PACKET_HEADER:
+                if data[i + 1:i + 3] != b"TL":
+                    i += 1
+                    continue
+                version = data[i + 3]
+                rate, i = read_varint(data, i + 4)
+                if version not in STREAM_VERSIONS:
+                    raise StreamError("stream version %d, this decoder reads versions %d to %d"
+                                      % (version, STREAM_VERSIONS[0], STREAM_VERSIONS[-1]))
+                sink.header(version, rate)
+            elif b == PACKET_NAME:
+                task, j = read_varint(data, i + 1)
+                length = data[j]
+                if j + 1 + length > n:
+                    break
+                sink.name(task, bytes(data[j + 1:j + 1 + length]).decode("utf-8", "replace"))
+                i = j + 1 + length
+            elif b == PACKET_DROPPED:
+                count, i = read_varint(data, i + 1)
+                sink.dropped(tick, count)
+            else:
+                # Not a packet start; a damaged stream resynchronises on the next one
+                i += 1
+        except IndexError:
+            break
+
+    if line:
+        sink.console(tick, line.decode("ascii", "replace").rstrip("\r"))
+    sink.events = events
+    sink.first_tick = first_tick
+    sink.last_tick = last_tick
+
+
+def read_varint(data, i):
+    """Returns (value, next index) for the varint at ``data[i]``."""
+    value = 0
+    shift = 0
+    while True:
+        b = data[i]
+        i += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, i
+        shift += 7
+
+
+# --- Outputs ---
+
+
+class Sink:
+    """Fans the decoded stream out to the requested outputs and keeps the
+    task names and totals they share."""
+
+    def __init__(self, tick_rate_hz):
+        self.tick_rate_hz = tick_rate_hz
+        self.names = {}
+        self.outputs = []
+        self.events = 0
+        self.dropped_records = 0
+        self.first_tick = None
+        self.last_tick = 0
+
+    def add(self, output):
+        self.outputs.append(output)
+        # One output, the usual case, gets the events without an extra call
+        if len(self.outputs) == 1:
+            self.event = output.event
+        else:
+            handlers = [out.event for out in self.outputs]
+
+            def fan_out(tick, task, event, arg, instance):
+                for handler in handlers:
+                    handler(tick, task, event, arg, instance)
+
+            self.event = fan_out
+
+    def task_name(self, task):
+        if task is SCHEDULER:
+            return "Scheduler"
+        return self.names.get(task) or "Task%d" % task
+
+    def job_name(self, task, instance):
+        name = self.task_name(task)
+        return "%s#%d" % (name, instance) if instance else name
+
+    def header(self, version, tick_rate_hz):
+        self.tick_rate_hz = tick_rate_hz
+        for out in self.outputs:
+            out.rate(tick_rate_hz)
+
+    def name(self, task, name):
+        self.names[task] = name
+        for out in self.outputs:
+            out.name(task, name)
+
+    def event(self, tick, task, event, arg, instance):
+        pass
+
+    def dropped(self, tick, count):
+        self.dropped_records += count
+        for out in self.outputs:
+            out.dropped(tick, count)
+
+    def console(self, tick, text):
+        for out in self.outputs:
+            out.console(tick, text)
+
+    def close(self):
+        for out in self.outputs:
+            out.close(self.last_tick)
+
+
+class Output:
+    """Common part of the outputs: buffered writing and tick conversion."""
+
+    def __init__(self, sink, f, unit_hz):
+        self.sink = sink
+        self.f = f
+        self.unit_hz = unit_hz
+        self.lines = []
+        self.rate(sink.tick_rate_hz)
+
+    def rate(self, tick_rate_hz):
+        # Exact integer scaling when the tick divides the output unit
+        self.scale = self.unit_hz // tick_rate_hz if self.unit_hz % tick_rate_hz == 0 else None
+        self.tick_rate_hz = tick_rate_hz
+
+    def units(self, tick):
+        if self.scale is not None:
+            return tick * self.scale
+        value = tick * self.unit_hz / self.tick_rate_hz
+        return int(value) if value == int(value) else round(value, 3)
+
+    def write(self, line):
+        lines = self.lines
+        lines.append(line)
+        if len(lines) >= 4096:
+            self.f.write("".join(lines))
+            del lines[:]
+
+    def flush(self):
+        self.f.write("".join(self.lines))
+        del self.lines[:]
+
+    def name(self, task, name):
+        pass
+
+    def dropped(self, tick, count):
+        pass
+
+    def console(self, tick, text):
+        pass
+
+    def close(self, last_tick):
+        self.flush()
+
+
+# Text of the events in the log, formatted with the task name and the argument
+TEXT_FORMATS = {
+    EV["TASK_COMPLETE"]: "{0} end",
+    EV["DEADLINE_MISS"]: "{0} deadline miss -> terminated",
+    EV["TASK_CREATE_FAILED"]: "{0} create failed",
+    EV["IDLE_START"]: "idle",
+    EV["IDLE_END"]: "idle end",
+    EV["SUBFRAME_START"]: "sub-frame {1}",
+    EV["FRAME_OVERRUN"]: "frame overrun by {1} ticks",
+    EV["SRT_INCOMPLETE"]: "{0} incomplete at frame end",
+    EV["SWITCH_REQUEST"]: "switch to schedule {1} requested",
+    EV["SCHEDULE_SWITCH"]: "schedule switched after {1} ticks",
+    EV["STACK_OVERFLOW"]: "{0} stack overflow",
+    EV["ABORT_REQUEST"]: "{0} abort requested",
+    EV["JOB_ABORTED"]: "{0} aborted after {1} ticks",
+    EV["JOB_RECLAIMED"]: "{0} reclaimed after {1} cycles",
+    EV["STATE_RESET"]: "state reset in {1} cycles",
+}
+
+
+class TextOutput(Output):
+    """The assignment's ``[ 21 ms ] Task_A start`` log."""
+
+    def __init__(self, sink, f, console=True):
+        Output.__init__(self, sink, f, 1000)
+        self.show_console = console
+        self.frames = 0
+
+    def event(self, tick, task, event, arg, instance):
+        if event == 1:
+            text = self.sink.job_name(task, instance) + (" start (degraded)" if arg else " start")
+        elif event == 0:
+            text = "major frame %d" % self.frames
+            self.frames += 1
+        elif event == 8:
+            text = "%s release skipped (%s)" % (self.sink.job_name(task, instance), SKIP_REASONS.get(arg, arg))
+        else:
+            form = TEXT_FORMATS.get(event)
+            if form is None:
+                form = "{0} event %d ({1})" % event
+            text = form.format(self.sink.job_name(task, instance), arg)
+        self.write("[ %s ms ] %s\n" % (self.units(tick), text))
+
+    def dropped(self, tick, count):
+        self.write("[ %s ms ] %d trace records dropped\n" % (self.units(tick), count))
+
+    def console(self, tick, text):
+        if self.show_console and text:
+            self.write("[ %s ms ] > %s\n" % (self.units(tick), text))
+
+
+class ChromeOutput(Output):
+    """Chrome Trace Event JSON, written as the stream is decoded."""
+
+    TID_FRAMES = 1
+    TID_IDLE = 2
+    TID_CONSOLE = 3
+    TID_TASK_BASE = 100
+
+    def __init__(self, sink, f):
+        Output.__init__(self, sink, f, 1000000)
+        self.jobs = {}            # task -> (start tick, quoted slice name)
+        self.major = None         # (start tick, frame number)
+        self.subframe = None      # (start tick, sub-frame id)
+        self.idle = None
+        self.frames = 0
+        self.lanes = set()
+        self.quoted = {}
+        self.sep = ""
+        f.write('{"displayTimeUnit":"ms","traceEvents":[\n')
+        self.meta("process_name", 0, '"name":"Timeline scheduler"')
+        for tid, name in ((self.TID_FRAMES, "Frames"), (self.TID_IDLE, "Idle"), (self.TID_CONSOLE, "Console")):
+            self.meta("thread_name", tid, '"name":"%s"' % name)
+            self.meta("thread_sort_index", tid, '"sort_index":%d' % tid)
+
+    def quote(self, text):
+        quoted = self.quoted.get(text)
+        if quoted is None:
+            quoted = json.dumps(text)
+            if len(self.quoted) < 4096:
+                self.quoted[text] = quoted
+        return quoted
+
+    def emit(self, record):
+        self.write(self.sep + record)
+        self.sep = ",\n"
+
+    def meta(self, kind, tid, args):
+        self.emit('{"ph":"M","pid":1,"tid":%d,"name":"%s","args":{%s}}' % (tid, kind, args))
+
+    def slice(self, tid, quoted_name, start, end, extra=""):
+        self.emit('{"ph":"X","pid":1,"tid":%d,"name":%s,"ts":%s,"dur":%s%s}'
+                  % (tid, quoted_name, self.units(start), self.units(max(end - start, 0)), extra))
+
+    def instant(self, tid, name, tick, arg=None, scope="t"):
+        self.emit('{"ph":"i","s":"%s","pid":1,"tid":%d,"name":%s,"ts":%s%s}'
+                  % (scope, tid, self.quote(name), self.units(tick),
+                     ',"args":{"arg":%d}' % arg if arg is not None else ""))
+
+    def lane(self, task):
+        if task is SCHEDULER:
+            return self.TID_FRAMES
+        tid = self.TID_TASK_BASE + task
+        if tid not in self.lanes:
+            self.lanes.add(tid)
+            self.meta("thread_name", tid, '"name":' + self.quote(self.sink.task_name(task)))
+            self.meta("thread_sort_index", tid, '"sort_index":%d' % tid)
+        return tid
+
+    def name(self, task, name):
+        if self.TID_TASK_BASE + task in self.lanes:
+            self.meta("thread_name", self.TID_TASK_BASE + task, '"name":' + self.quote(name))
+
+    def end_job(self, task, tick, how):
+        job = self.jobs.pop(task, None)
+        if job is not None:
+            self.slice(self.lane(task), job[1], job[0], tick,
+                       ',"args":{"end":"%s"}%s' % (how, ',"cname":"terrible"' if how == "killed" else ""))
+
+    def end_subframe(self, tick):
+        if self.subframe is not None:
+            self.slice(self.TID_FRAMES, '"sub-frame %d"' % self.subframe[1], self.subframe[0], tick)
+            self.subframe = None
+
+    def event(self, tick, task, event, arg, instance):
+        if event == 1:
+            self.end_job(task, tick, "released again")
+            name = self.sink.job_name(task, instance)
+            self.jobs[task] = (tick, self.quote(name + " (degraded)" if arg else name))
+        elif event in JOB_ENDS:
+            self.end_job(task, tick, JOB_ENDS[event])
+            if event == 3:
+                self.instant(self.lane(task), "deadline miss, killed", tick)
+        elif event == 0:
+            self.end_subframe(tick)
+            if self.major is not None:
+                self.slice(self.TID_FRAMES, '"major frame %d"' % self.major[1], self.major[0], tick)
+            self.major = (tick, self.frames)
+            self.frames += 1
+        elif event == 7:
+            self.end_subframe(tick)
+            self.subframe = (tick, arg)
+        elif event == 5:
+            self.idle = tick
+        elif event == 6:
+            if self.idle is not None:
+                self.slice(self.TID_IDLE, '"idle"', self.idle, tick)
+                self.idle = None
+        elif event == 8:
+            self.instant(self.lane(task), "release skipped (%s)" % SKIP_REASONS.get(arg, arg), tick)
+        else:
+            name = EVENTS[event].lower() if event < len(EVENTS) else "event %d" % event
+            self.instant(self.lane(task), name, tick, arg)
+
+    def dropped(self, tick, count):
+        self.instant(self.TID_FRAMES, "%d records dropped" % count, tick, scope="g")
+
+    def console(self, tick, text):
+        if text:
+            self.instant(self.TID_CONSOLE, text, tick)
+
+    def close(self, last_tick):
+        for task in list(self.jobs):
+            self.end_job(task, last_tick, "end of capture")
+        self.end_subframe(last_tick)
+        if self.major is not None:
+            self.slice(self.TID_FRAMES, '"major frame %d"' % self.major[1], self.major[0], last_tick)
+        if self.idle is not None:
+            self.slice(self.TID_IDLE, '"idle"', self.idle, last_tick)
+        self.write("\n]}\n")
+        self.flush()
+
+
+class VcdOutput(Output):
+    """Value change dump in microseconds. Signals are only known once the
+    stream has been read, so the changes go to a temporary file and the
+    header is written at the end."""
+
+    def __init__(self, sink, f):
+        Output.__init__(self, sink, tempfile.TemporaryFile(mode="w+"), 1000000)
+        self.out = f
+        self.codes = {}
+        self.time = -1
+
+    def code(self, key):
+        code = self.codes.get(key)
+        if code is None:
+            index = len(self.codes)
+            code = ""
+            while True:
+                code += chr(33 + index % 94)
+                index //= 94
+                if index == 0:
+                    break
+            self.codes[key] = code
+        return code
+
+    def change(self, tick, value):
+        # Records from preempted producers may be a tick late; VCD time cannot go back
+        time = self.units(tick)
+        if time > self.time:
+            self.time = time
+            self.write("#%d\n%s\n" % (time, value))
+        else:
+            self.write(value + "\n")
+
+    def event(self, tick, task, event, arg, instance):
+        if event == 1:
+            self.change(tick, "1" + self.code(task))
+        elif event in JOB_ENDS:
+            if event == 3:
+                self.change(tick, "0%s\n1%s" % (self.code(task), self.code(("kill", task))))
+            else:
+                self.change(tick, "0" + self.code(task))
+        elif event == 0:
+            self.change(tick, "1" + self.code("major"))
+        elif event == 7:
+            self.change(tick, "b%s %s" % (format(arg, "b"), self.code("subframe")))
+        elif event == 5:
+            self.change(tick, "1" + self.code("idle"))
+        elif event == 6:
+            self.change(tick, "0" + self.code("idle"))
+
+    def close(self, last_tick):
+        self.flush()
+        f = self.out
+        f.write("$comment timeline scheduler trace $end\n$timescale 1 us $end\n$scope module timeline $end\n")
+        for key, code in self.codes.items():
+            if key == "major":
+                f.write("$var event 1 %s major_frame $end\n" % code)
+            elif key == "subframe":
+                f.write("$var wire 8 %s subframe $end\n" % code)
+            elif key == "idle":
+                f.write("$var wire 1 %s idle $end\n" % code)
+            else:
+                task = key[1] if isinstance(key, tuple) else key
+                name = "".join(c if c.isalnum() or c == "_" else "_" for c in self.sink.task_name(task))
+                if isinstance(key, tuple):
+                    f.write("$var event 1 %s %s_killed $end\n" % (code, name))
+                else:
+                    f.write("$var wire 1 %s %s $end\n" % (code, name))
+        f.write("$upscope $end\n$enddefinitions $end\n")
+        self.f.seek(0)
+        shutil.copyfileobj(self.f, f)
+        self.f.close()
+
+
+# --- Command Line ---
+
+
+def open_output(path):
+    return sys.stdout if path == "-" else open(path, "w")
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Decode a binary timeline scheduler trace.")
+    parser.add_argument("capture", help="UART capture of a TRACE_OUTPUT_BINARY build ('-' for stdin)")
+    parser.add_argument("--text", metavar="FILE", help="write the readable log to FILE ('-' for stdout)")
+    parser.add_argument("--chrome", metavar="FILE", help="write Chrome Trace Event / Perfetto JSON to FILE")
+    parser.add_argument("--vcd", metavar="FILE", help="write a VCD waveform to FILE")
+    parser.add_argument("--no-console", action="store_true", help="leave the jobs' own output out of the log")
+    parser.add_argument("--tick-rate", type=int, default=DEFAULT_TICK_RATE_HZ,
+                        help="tick rate in Hz until the stream header says otherwise (default: %d)"
+                        % DEFAULT_TICK_RATE_HZ)
+    parser.add_argument("--summary", action="store_true", help="print totals to stderr")
+    args = parser.parse_args(argv)
+
+    # Piping the log into head or less must not end in a traceback
+    if hasattr(signal, "SIGPIPE"):
+        signal.signal(signal.SIGPIPE, signal.SIG_DFL)
+
+    if args.text is None and args.chrome is None and args.vcd is None:
+        args.text = "-"
+
+    try:
+        if args.capture == "-":
+            data = sys.stdin.buffer.read()
+        else:
+            with open(args.capture, "rb") as f:
+                data = f.read()
+    except OSError as exc:
+        print("error: %s" % exc, file=sys.stderr)
+        return 2
+
+    sink = Sink(args.tick_rate)
+    files = []
+    try:
+        if args.text is not None:
+            files.append(open_output(args.text))
+            sink.add(TextOutput(sink, files[-1], not args.no_console))
+        if args.chrome is not None:
+            files.append(open_output(args.chrome))
+            sink.add(ChromeOutput(sink, files[-1]))
+        if args.vcd is not None:
+            files.append(open_output(args.vcd))
+            sink.add(VcdOutput(sink, files[-1]))
+
+        status = 0
+        try:
+            decode(memoryview(data), sink)
+        except StreamError as exc:
+            print("error: %s" % exc, file=sys.stderr)
+            status = 1
+        sink.close()
+    except OSError as exc:
+        print("error: %s" % exc, file=sys.stderr)
+        return 2
+    finally:
+        for f in files:
+            if f is not sys.stdout:
+                f.close()
+
+    if args.summary:
+        span = (sink.last_tick - (sink.first_tick or 0)) / sink.tick_rate_hz
+        print("%d bytes, %d records over %.3f s, %d dropped on the target, %d tasks"
+              % (len(data), sink.events, span, sink.dropped_records, len(sink.names)), file=sys.stderr)
+    if sink.events == 0 and status == 0:
+        print("warning: no trace records found; was the firmware built with TRACE_OUTPUT_BINARY=1?",
+              file=sys.stderr)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())